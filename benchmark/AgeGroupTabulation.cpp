@@ -0,0 +1,127 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2025 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2025 University of Basel
+ * Copyright (C) 2025 The Kids Research Institute Australia
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+/* Cost of AgeGroupInterpolator::eval for piecewise-linear data: a
+ * std::map::upper_bound per call (the default) versus a table indexed by age
+ * in time steps (--tabulate-age-groups).
+ *
+ * AgeGroupInterpolator needs sim::init() and XML input, so the same two
+ * lookups are reproduced here on the 1-day and 5-day grids up to 90 years,
+ * with a typical number of age groups (as for body mass). Ages are those of
+ * a population (uniform over 0-90 years) at one time step. */
+
+#include "Benchmark.h"
+
+#include <cmath>
+#include <limits>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const int DAYS_IN_YEAR = 365;
+const int MAX_AGE_DAYS = 90 * DAYS_IN_YEAR;
+
+inline double inYears( int days ){ return days * (1.0 / DAYS_IN_YEAR); }
+
+struct Linear {
+    Linear(){
+        const double lbounds[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 20, 25, 35, 45, 55 };
+        const size_t n = sizeof(lbounds) / sizeof(lbounds[0]);
+        double last = 0.0, lastValue = 10.0;
+        for( size_t i = 0; i < n; ++i ){
+            points[ 0.5 * (last + lbounds[i]) ] = lastValue;
+            last = lbounds[i];
+            lastValue = 10.0 + 4.0 * i;
+        }
+        points[ 0.5 * (last + 90.0) ] = lastValue;
+        points[ 0.0 ] = points.begin()->second;
+        points[ numeric_limits<double>::infinity() ] = points.rbegin()->second;
+    }
+    
+    double eval( double ageYears ) const{
+        auto it = points.upper_bound( ageYears );
+        double a1 = it->first, f1 = it->second;
+        --it;
+        double a0 = it->first, f0 = it->second;
+        return (ageYears - a0) / (a1 - a0) * (f1 - f0) + f0;
+    }
+    
+    map<double,double> points;
+};
+
+struct Tabulated {
+    Tabulated( const Linear& linear, int interval ) : interval(interval),
+        stepsPerYear(static_cast<double>(DAYS_IN_YEAR) / interval),
+        table(MAX_AGE_DAYS / interval + 1)
+    {
+        for( size_t i = 0; i < table.size(); ++i ) table[i] = linear.eval( inYears( interval * int(i) ) );
+    }
+    
+    double eval( const Linear& linear, double ageYears ) const{
+        const long steps = lround( ageYears * stepsPerYear );
+        if( steps >= 0 && static_cast<size_t>(steps) < table.size() &&
+            inYears( interval * int(steps) ) == ageYears )
+            return table[steps];
+        return linear.eval( ageYears );
+    }
+    
+    int interval;
+    double stepsPerYear;
+    vector<double> table;
+};
+
+}
+
+int main(){
+    const Linear linear;
+    const size_t size = 100000;
+    cout << "Evaluating for " << size << " humans; time per step:" << endl;
+    for( int interval : { 1, 5 } ){
+        Tabulated tabulated( linear, interval );
+        mt19937 gen( 7 );
+        uniform_int_distribution<int> dist( 0, MAX_AGE_DAYS / interval );
+        vector<double> ages( size );
+        for( double& age : ages ) age = inYears( interval * dist(gen) );
+        
+        double sum0 = 0.0, sum1 = 0.0;
+        double t = bench::timePerCall( [&](){
+            sum0 = 0.0;
+            for( double age : ages ) sum0 += linear.eval( age );
+        } );
+        bench::report( interval == 1 ? "map, 1-day steps" : "map, 5-day steps", size, t );
+        t = bench::timePerCall( [&](){
+            sum1 = 0.0;
+            for( double age : ages ) sum1 += tabulated.eval( linear, age );
+        } );
+        bench::report( interval == 1 ? "table, 1-day steps" : "table, 5-day steps", size, t );
+        if( sum0 != sum1 ){
+            cerr << "mismatch: " << sum0 << " vs " << sum1 << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
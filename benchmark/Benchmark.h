@@ -0,0 +1,61 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2025 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2025 University of Basel
+ * Copyright (C) 2025 The Kids Research Institute Australia
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+// Timing helpers shared by the micro-benchmarks.
+
+#ifndef Hmod_Benchmark
+#define Hmod_Benchmark
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace bench {
+
+/** Run f (after one untimed call) until at least minSeconds have elapsed, and
+ * return the mean time per call in seconds. */
+inline double timePerCall( const std::function<void()>& f, double minSeconds = 0.5 ){
+    using clock = std::chrono::steady_clock;
+    f();
+    size_t n = 0;
+    clock::time_point start = clock::now();
+    double elapsed = 0.0;
+    do{
+        f();
+        ++n;
+        elapsed = std::chrono::duration<double>( clock::now() - start ).count();
+    }while( elapsed < minSeconds );
+    return elapsed / n;
+}
+
+/// Print one result line: name, problem size and time per call
+inline void report( const std::string& name, size_t size, double seconds ){
+    std::cout << std::left << std::setw(32) << name
+        << std::right << std::setw(10) << size
+        << std::setw(14) << std::setprecision(4) << seconds * 1e6 << " µs" << std::endl;
+}
+
+}
+
+#endif
@@ -0,0 +1,109 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2025 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2025 University of Basel
+ * Copyright (C) 2025 The Kids Research Institute Australia
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/* Time to write and read a checkpoint: the old method, with each value
+ * written by operator& directly to a (single-threaded) gzstream, versus
+ * serialising to memory and compressing blocks in parallel with
+ * util::gzblocks.
+ *
+ * Human needs a fully initialised model, so each stand-in human is a mix of
+ * doubles and small integers similar in size to a real one (a few hundred
+ * bytes), written one value at a time as Human::checkpoint does. */
+
+#include "Benchmark.h"
+#include "Global.h"
+#include "util/gzblocks.h"
+
+#include <cstdio>
+#include <gzstream/gzstream.h>
+#include <random>
+#include <sstream>
+#include <vector>
+
+using namespace OM::util::checkpoint;
+
+namespace {
+
+const char* FILE_NAME = "CheckpointGzip.gz";
+
+struct FakeHuman {
+    double doubles[32];
+    int ints[16];
+    bool flags[8];
+
+    template<class S>
+    void operator& (S& stream){
+        for( double& x : doubles ) x & stream;
+        for( int& x : ints ) x & stream;
+        for( bool& x : flags ) x & stream;
+    }
+};
+
+vector<FakeHuman> makePopulation( size_t size ){
+    mt19937 gen( 7 );
+    uniform_real_distribution<double> real( 0.0, 1.0 );
+    uniform_int_distribution<int> small( 0, 100 );
+    vector<FakeHuman> humans( size );
+    for( FakeHuman& h : humans ){
+        for( size_t i = 0; i < 32; ++i ) h.doubles[i] = i < 8 ? real( gen ) : (i % 3) * 0.5;
+        for( int& x : h.ints ) x = small( gen );
+        for( bool& x : h.flags ) x = small( gen ) < 10;
+    }
+    return humans;
+}
+
+void writeGzstream( vector<FakeHuman>& humans ){
+    ogzstream out( FILE_NAME, ios::out | ios::binary );
+    for( FakeHuman& h : humans ) h & out;
+    out.close();
+}
+
+void readGzstream( vector<FakeHuman>& humans ){
+    igzstream in( FILE_NAME, ios::in | ios::binary );
+    for( FakeHuman& h : humans ) h & in;
+}
+
+void writeBlocks( vector<FakeHuman>& humans ){
+    ostringstream out( ios::out | ios::binary );
+    for( FakeHuman& h : humans ) h & out;
+    OM::util::gzblocks::writeFile( FILE_NAME, out.str() );
+}
+
+void readBlocks( vector<FakeHuman>& humans ){
+    istringstream in( OM::util::gzblocks::readFile( FILE_NAME ), ios::in | ios::binary );
+    for( FakeHuman& h : humans ) h & in;
+}
+
+}
+
+int main(){
+    cout << "Checkpoint of n humans; time per write or read:" << endl;
+    for( size_t size : { 10000, 100000 } ){
+        vector<FakeHuman> humans = makePopulation( size );
+        bench::report( "write gzstream (old)", size, bench::timePerCall( [&](){ writeGzstream( humans ); } ) );
+        bench::report( "read gzstream (old)", size, bench::timePerCall( [&](){ readGzstream( humans ); } ) );
+        bench::report( "write gzblocks", size, bench::timePerCall( [&](){ writeBlocks( humans ); } ) );
+        bench::report( "read gzblocks", size, bench::timePerCall( [&](){ readBlocks( humans ); } ) );
+    }
+    std::remove( FILE_NAME );
+    return 0;
+}
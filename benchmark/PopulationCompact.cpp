@@ -0,0 +1,107 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2025 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2025 University of Basel
+ * Copyright (C) 2025 The Kids Research Institute Australia
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/* Per-step cost of removing dead humans in Population::update: repeated
+ * vector::erase (the old method) versus util::vectors::compact.
+ *
+ * Human itself needs a fully initialised model, so a stand-in with a similar
+ * layout (owned sub-models, vectors and a map) is used. With a 1-day step and
+ * a mean life of 50 years, about n/18250 humans die per step at random ages. */
+
+#include "Benchmark.h"
+#include "util/vectors.h"
+
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct SubModel {
+    vector<double> state = vector<double>( 8, 0.0 );
+};
+
+struct FakeHuman {
+    explicit FakeHuman( int dob ) : dob(dob),
+        withinHost(new SubModel), clinical(new SubModel), infIncidence(new SubModel) {}
+    FakeHuman(FakeHuman&&) = default;
+    FakeHuman& operator=(FakeHuman&&) = default;
+
+    int dob;
+    bool dead = false;
+    unique_ptr<SubModel> withinHost, clinical, infIncidence;
+    vector<double> availability = vector<double>( 3, 1.0 );
+    map<int, int> subPopExp;
+};
+
+const double DEATHS_PER_STEP = 1.0 / 18250.0;
+
+void killSome( vector<FakeHuman>& humans, mt19937& gen ){
+    size_t nDeaths = max<size_t>( 1, humans.size() * DEATHS_PER_STEP );
+    uniform_int_distribution<size_t> dist( 0, humans.size() - 1 );
+    for( size_t i = 0; i < nDeaths; ++i ) humans[dist(gen)].dead = true;
+}
+
+void refill( vector<FakeHuman>& humans, size_t size, int& now ){
+    ++now;
+    while( humans.size() < size ) humans.push_back( FakeHuman(now) );
+}
+
+void updateErase( vector<FakeHuman>& humans ){
+    for( auto it = humans.begin(); it != humans.end(); ){
+        if( it->dead ){
+            it = humans.erase( it );
+            continue;
+        }
+        ++it;
+    }
+}
+
+void updateCompact( vector<FakeHuman>& humans ){
+    OM::util::vectors::compact( humans, []( const FakeHuman& h ){ return h.dead; } );
+}
+
+}
+
+int main(){
+    cout << "Removing ~1/18250 of humans per step; time per step:" << endl;
+    for( size_t size : { 10000, 100000, 1000000 } ){
+        for( int method = 0; method < 2; ++method ){
+            vector<FakeHuman> humans;
+            humans.reserve( size );
+            int now = 0;
+            for( size_t i = 0; i < size; ++i ) humans.push_back( FakeHuman(now - int(size - i)) );
+            mt19937 gen( 7 );
+            double t = bench::timePerCall( [&](){
+                killSome( humans, gen );
+                if( method == 0 ) updateErase( humans );
+                else updateCompact( humans );
+                refill( humans, size, now );
+            } );
+            bench::report( method == 0 ? "erase (old)" : "compact", size, t );
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2025 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2025 University of Basel
+ * Copyright (C) 2025 The Kids Research Institute Australia
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+/* Cost of selecting the target humans of a timed deployment: scanning the
+ * whole population and testing each age (the old method) versus
+ * Population::ageRange, which binary-searches the date-of-birth ordering.
+ *
+ * Human itself needs a fully initialised model, so a stand-in with a date of
+ * birth is used. Ages are uniform over 0-90 years, oldest first; the target
+ * group is 3-59 months, as for a round of seasonal malaria chemoprevention. */
+
+#include "Benchmark.h"
+#include "Population.h"
+
+#include <vector>
+
+using namespace std;
+using namespace OM;
+
+namespace {
+
+struct FakeHuman {
+    explicit FakeHuman( SimTime dob ) : dob(dob) {}
+    inline SimTime age( SimTime time ) const { return time - dob; }
+
+    SimTime dob;
+    double availability = 1.0;
+    bool deployed = false;
+};
+
+size_t deployScan( vector<FakeHuman>& humans, SimTime now, SimTime minAge, SimTime maxAge ){
+    size_t n = 0;
+    for( FakeHuman& human : humans ){
+        const SimTime age = human.age( now );
+        if( age >= minAge && age < maxAge ){
+            human.deployed = human.availability > 0.5;
+            ++n;
+        }
+    }
+    return n;
+}
+
+size_t deployRange( vector<FakeHuman>& humans, SimTime now, SimTime minAge, SimTime maxAge ){
+    auto range = Population::ageRange( humans.begin(), humans.end(), now, minAge, maxAge );
+    for( auto it = range.first; it != range.second; ++it ){
+        it->deployed = it->availability > 0.5;
+    }
+    return range.second - range.first;
+}
+
+}
+
+int main(){
+    const SimTime now = sim::fromDays( 100 * 365 );
+    const SimTime minAge = sim::fromDays( 3 * 30 ), maxAge = sim::fromDays( 59 * 30 );
+    const int maxDays = 90 * 365;
+    cout << "Selecting humans aged 3-59 months; time per deployment:" << endl;
+    for( size_t size : { 100000, 1000000 } ){
+        vector<FakeHuman> humans;
+        humans.reserve( size );
+        for( size_t i = 0; i < size; ++i ){
+            humans.push_back( FakeHuman( now - sim::fromDays( maxDays - int(i * maxDays / size) ) ) );
+        }
+        size_t n0 = 0, n1 = 0;
+        double t = bench::timePerCall( [&](){ n0 = deployScan( humans, now, minAge, maxAge ); } );
+        bench::report( "full scan (old)", size, t );
+        t = bench::timePerCall( [&](){ n1 = deployRange( humans, now, minAge, maxAge ); } );
+        bench::report( "ageRange", size, t );
+        if( n0 != n1 ){
+            cerr << "mismatch: " << n0 << " vs " << n1 << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -31,6 +31,7 @@
 #include "util/CommandLine.h"
 #include "util/errors.h"
 #include "util/UnitParse.h"
+#include "util/parallel.h"
 #include "schema/scenario.h"
 
 namespace OM { namespace Clinical {
@@ -219,10 +220,16 @@ void InfantMortality::staticCheckpoint (ostream& stream) {
     infantIntervalsAtRisk & stream;
 }
 
+// Risk reports (index, isDoomed) made while updating humans in parallel
+util::parallel::Journal<pair<size_t, bool>> infantRiskJournal(
+    []( const pair<size_t, bool>& r ){
+        infantIntervalsAtRisk[r.first] += 1;     // baseline
+        if (r.second)
+            infantDeaths[r.first] += 1;  // deaths
+    } );
+
 void InfantMortality::reportRisk(size_t index, bool isDoomed) {
-    infantIntervalsAtRisk[index] += 1;     // baseline
-    if (isDoomed)
-        infantDeaths[index] += 1;  // deaths
+    infantRiskJournal.record( make_pair(index, isDoomed) );
 }
 
 double InfantMortality::allCause(){
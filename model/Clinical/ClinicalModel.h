@@ -102,6 +102,12 @@ public:
     inline void flushReports (){
         latestReport.flush();
     }
+    
+    /// Report the last episode if it can no longer be extended. This does not
+    /// affect output, but lets surveys be completed sooner.
+    inline void flushCompleteReports (){
+        latestReport.flushIfComplete();
+    }
 
     inline const Episode &getLatestReport () const{
         return latestReport;
@@ -24,6 +24,7 @@
 #include "Clinical/ClinicalModel.h"
 #include "Host/Human.h"
 #include "Host/WithinHost/WHInterface.h"
+#include "mon/management.h"
 
 namespace OM {
 namespace Clinical {
@@ -38,6 +39,26 @@ void Episode::flush() {
     time = sim::never();
 }
 
+void Episode::flushIfComplete() {
+    if (time < sim::zero())        // Nothing to report
+        return;
+    // Same test as in update(), for the next update (when ts0 is now)
+    bool complete = healthSystemMemoryFix ?
+        (time + ClinicalModel::hsMemory() <= sim::now()) :
+        (time + ClinicalModel::hsMemory() < sim::now());
+    if (!complete)
+        return;
+    
+    // update() reports the infection origin at the time of the next episode,
+    // which is not known yet. If reported, keep the survey open instead.
+    if (mon::isUsedM(mon::MHE_UNCOMPLICATED_EPISODES_INDIGENOUS) ||
+        mon::isUsedM(mon::MHE_UNCOMPLICATED_EPISODES_INTRODUCED) ||
+        mon::isUsedM(mon::MHE_UNCOMPLICATED_EPISODES_IMPORTED))
+        mon::holdSurvey(surveyPeriod);
+    else
+        flush();
+}
+
 
 void Episode::update (const Host::Human& human, Episode::State newState)
 {
@@ -96,6 +96,13 @@ public:
     /// Report anything pending, as on destruction
     void flush();
     
+    /** Report the episode now if it can no longer be extended, as update()
+     * would on the next event. This does not change any output: where the
+     * report would depend on the next event (infection origin), the episode
+     * is left pending and its survey held open (mon::holdSurvey). Call
+     * between updates. */
+    void flushIfComplete();
+    
     /** Report an episode, its severity, and any outcomes it entails.
      *
      * @param human The human whose info is being reported
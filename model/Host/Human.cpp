@@ -26,6 +26,7 @@
 #include "Host/WithinHost/WHInterface.h"
 
 #include "Transmission/TransmissionModel.h"
+#include "util/CommandLine.h"
 #include "util/ModelOptions.h"
 #include "util/vectors.h"
 #include "util/StreamValidator.h"
@@ -124,7 +125,9 @@ Human::Human(SimTime dateOfBirth) :
 void Human::addToCohort(ComponentId id, SimTime duration )
 {
     if( duration <= sim::zero() ) return; // nothing to do
-    subPopExp[id] = sim::nowOrTs1() + duration;
+    const SimTime expiry = sim::nowOrTs1() + duration;
+    subPopExp[id] = expiry;
+    nextSubPopExp = std::min( nextSubPopExp, expiry );
     cohortSet = mon::updateCohortSet( cohortSet, id, true );
 }
 
@@ -159,6 +162,8 @@ void Human::removeFirstEvent(interventions::SubPopRemove::RemoveAtCode code )
 void Human::updateCohortSet()
 {
     // check sub-pop expiry
+    if( nextSubPopExp >= sim::ts0() ) return;   // nothing expires yet
+    nextSubPopExp = sim::future();
     for( auto expIt = subPopExp.begin(), expEnd = subPopExp.end(); expIt != expEnd; ) {
         if( !(expIt->second >= sim::ts0()) ){       // membership expired
             // don't flush reports
@@ -168,6 +173,7 @@ void Human::updateCohortSet()
             // erase element, but continue iteration
             expIt = subPopExp.erase( expIt );
         }else{
+            nextSubPopExp = std::min( nextSubPopExp, expIt->second );
             ++expIt;
         }
     }
@@ -184,8 +190,9 @@ void Human::checkpoint(istream &stream)
     vaccine & stream;
     monitoringAgeGroup & stream;
     cohortSet & stream;
-    nextCtsDist & stream;
     subPopExp & stream;
+    nextSubPopExp = sim::future();
+    for( auto& exp : subPopExp ) nextSubPopExp = std::min( nextSubPopExp, exp.second );
 }
 
 void Human::checkpoint(ostream &stream)
@@ -199,12 +206,16 @@ void Human::checkpoint(ostream &stream)
     vaccine & stream;
     monitoringAgeGroup & stream;
     cohortSet & stream;
-    nextCtsDist & stream;
     subPopExp & stream;
 }
 
 // -----  Non-static functions: per-time-step update  -----
 void summarize(Human &human, bool surveyOnlyNewEp) {
+    // With streaming output, surveys are written once no more episodes can
+    // be reported to them
+    if( util::CommandLine::option( util::CommandLine::STREAM_OUTPUT ) )
+        human.clinicalModel->flushCompleteReports();
+    
     if( surveyOnlyNewEp && human.clinicalModel->isExistingCase() ){
         // This modifies the denominator to treat the health-system-memory
         // period immediately after a bout as 'not at risk'.
@@ -245,7 +256,9 @@ void update(Human &human, Transmission::TransmissionModel& transmission)
     double age1 = sim::inYears(human.age(sim::ts1()));
 
     // age1 used only in PerHost::relativeAvailabilityAge(); difference to age0 should be minor
-    vector<double> EIR_per_genotype_i, EIR_per_genotype_l;
+    // Scratch space reused between humans (one per thread since humans may
+    // be updated in parallel); getEIR sets size and all values.
+    thread_local vector<double> EIR_per_genotype_i, EIR_per_genotype_l;
     transmission.getEIR(human, age0, age1, EIR_per_genotype_i, EIR_per_genotype_l);
 
     double EIR_i = util::vectors::sum(EIR_per_genotype_i);
@@ -120,9 +120,6 @@ public:
     /** Made persistant to save a lookup each time step (significant performance improvement) */
     mon::AgeGroup monitoringAgeGroup;
 
-    /** The next continuous distribution in the series */
-    uint32_t nextCtsDist = 0;
-
 private:
     SimTime dateOfBirth = sim::never();        // date of birth; humans are always born at the end of a time step
 
@@ -146,6 +143,11 @@ private:
     //TODO(optimisation): it might be better to instead store for each
     // ComponentId of interest the set of humans who are members
     std::map<interventions::ComponentId,SimTime> subPopExp;
+    
+    /** No entry of subPopExp expires before this time, so updateCohortSet()
+     * need not look at subPopExp until ts0() passes it. Not checkpointed
+     * (recalculated from subPopExp). */
+    SimTime nextSubPopExp = sim::future();
 };
 
 void summarize(Human &human, bool surveyOnlyNewEp);
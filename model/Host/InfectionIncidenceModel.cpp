@@ -66,6 +66,8 @@ bool opt_neg_bin_mass_action = false, opt_lognormal_mass_action = false,
 
 // ———  variables  ———
 int InfectionIncidenceModel::ctsNewInfections = 0;
+util::parallel::Journal<int> InfectionIncidenceModel::ctsNewInfectionsJournal(
+    []( const int& n ){ InfectionIncidenceModel::ctsNewInfections += n; } );
 
 // -----  static initialisation  -----
 
@@ -268,7 +270,7 @@ void InfectionIncidenceModel::reportNumNewInfections(Human& human, int newNumInf
     mon::reportEventMHI( mon::MHR_NEW_INFECTIONS, human, newNumInfections_i+newNumInfections_l);
     mon::reportEventMHI( mon::MHR_NEW_INFECTIONS_INTRODUCED, human, newNumInfections_i);
     mon::reportEventMHI( mon::MHR_NEW_INFECTIONS_INDIGENOUS, human, newNumInfections_l);
-    ctsNewInfections += newNumInfections_i+newNumInfections_l;
+    ctsNewInfectionsJournal.record( newNumInfections_i+newNumInfections_l );
 }
 
 } }
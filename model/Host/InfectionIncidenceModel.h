@@ -26,6 +26,7 @@
 #include "Global.h"
 #include "Transmission/PerHost.h"
 #include "util/random.h"
+#include "util/parallel.h"
 
 namespace OM {
     class Parameters;
@@ -146,6 +147,8 @@ protected:
   
     /// Number of new infections introduced, per continuous reporting period
     static int ctsNewInfections;
+    /// Additions to ctsNewInfections made while updating humans in parallel
+    static util::parallel::Journal<int> ctsNewInfectionsJournal;
 };
 
 //TODO(optimisation): none of these add data members, so should we be using
@@ -30,6 +30,7 @@
 #include "util/AgeGroupInterpolation.h"
 #include "util/random.h"
 #include "util/StreamValidator.h"
+#include "util/vectors.h"
 #include "schema/scenario.h"
 
 using namespace std;
@@ -95,17 +96,16 @@ CommonWithinHost::~CommonWithinHost() {
 // -----  Simple infection adders/removers  -----
 
 void CommonWithinHost::clearInfections( Treatments::Stages stage ){
-    for(auto inf = infections.begin(); inf != infections.end();) {
+    util::vectors::compact( infections, [stage]( CommonInfection* inf ){
         if( stage == Treatments::BOTH ||
-            (stage == Treatments::LIVER && !(*inf)->bloodStage()) ||
-            (stage == Treatments::BLOOD && (*inf)->bloodStage())
+            (stage == Treatments::LIVER && !inf->bloodStage()) ||
+            (stage == Treatments::BLOOD && inf->bloodStage())
         ){
-            delete *inf;
-            inf = infections.erase( inf );
-        }else{
-            ++inf;
+            delete inf;
+            return true;
         }
-    }
+        return false;
+    } );
     numInfs = infections.size();
 }
 
@@ -198,49 +198,58 @@ void CommonWithinHost::update(Host::Human &human, LocalRng& rng, int &nNewInfs_i
     hrp2Density = 0.0;
     timeStepMaxDensity = 0.0;
     
-    bool treatmentLiver = treatExpiryLiver > sim::ts0();
-    bool treatmentBlood = treatExpiryBlood > sim::ts0();
-    
-    double body_mass = massByAge.eval( ageInYears ) * hetMassMultiplier;
+    // Quiescent host: with no infections and no drugs the daily loop below
+    // has no effect and uses no random numbers, so skip it. Immunity decay
+    // (above) and the density cache (below) are still updated.
+    const bool quiescent = infections.empty() && pkpdModel.isEmpty();
     
-    for( SimTime now = sim::ts0(), end = sim::ts0() + sim::oneTS(); now < end; now = now + sim::oneDay() ){
-        // every day, medicate drugs, update each infection, then decay drugs
-        pkpdModel.medicate(rng);
+    if( !quiescent ){
+        bool treatmentLiver = treatExpiryLiver > sim::ts0();
+        bool treatmentBlood = treatExpiryBlood > sim::ts0();
         
-        double sumLogDens = 0.0;
+        double body_mass = massByAge.eval( ageInYears ) * hetMassMultiplier;
         
-        for(auto inf = infections.begin(); inf != infections.end();) {
-            // Note: this is only one treatment model; there is also the PK/PD model
-            bool expires = ((*inf)->bloodStage() ? treatmentBlood : treatmentLiver);
-            
-            if( !expires ){     /* no expiry due to simple treatment model; do update */
-                const double drugFactor = pkpdModel.getDrugFactor(rng, *inf, body_mass);
-                const double immFactor = immunitySurvivalFactor(ageInYears, (*inf)->cumulativeExposureJ());
-                const double bsvFactor = human.vaccine.getFactor(interventions::Vaccine::BSV, opt_vaccine_genotype? (*inf)->genotype() : 0);
-                const double survivalFactor = bsvFactor * _innateImmSurvFact * immFactor * drugFactor;
-                // update, may result in termination of infection:
-                expires = (*inf)->update(rng, survivalFactor, now, body_mass);
-            }
+        for( SimTime now = sim::ts0(), end = sim::ts0() + sim::oneTS(); now < end; now = now + sim::oneDay() ){
+            // every day, medicate drugs, update each infection, then decay drugs
+            pkpdModel.medicate(rng);
+        
+            double sumLogDens = 0.0;
+        
+            // Surviving infections are moved down over expired ones, keeping order
+            auto kept = infections.begin();
+            for(auto inf = infections.begin(); inf != infections.end(); ++inf) {
+                // Note: this is only one treatment model; there is also the PK/PD model
+                bool expires = ((*inf)->bloodStage() ? treatmentBlood : treatmentLiver);
             
-            if( expires ){
-                delete *inf;
-                inf = infections.erase(inf);        // inf points to next infection now so don't increment with ++inf
-                --numInfs;
-            } else {
-                double density = (*inf)->getDensity();
-                totalDensity += density;
-                if( !(*inf)->isHrp2Deficient() ){
-                    hrp2Density += density;
+                if( !expires ){     /* no expiry due to simple treatment model; do update */
+                    const double drugFactor = pkpdModel.getDrugFactor(rng, *inf, body_mass);
+                    const double immFactor = immunitySurvivalFactor(ageInYears, (*inf)->cumulativeExposureJ());
+                    const double bsvFactor = human.vaccine.getFactor(interventions::Vaccine::BSV, opt_vaccine_genotype? (*inf)->genotype() : 0);
+                    const double survivalFactor = bsvFactor * _innateImmSurvFact * immFactor * drugFactor;
+                    // update, may result in termination of infection:
+                    expires = (*inf)->update(rng, survivalFactor, now, body_mass);
                 }
-                timeStepMaxDensity = max(timeStepMaxDensity, density);
-                if( density > 0 ){
-                    // Base 10 logarithms are usually used; +1 because it avoids negatives in output while having very little affect on high densities
-                    sumLogDens += log10(1.0 + density);
+            
+                if( expires ){
+                    delete *inf;
+                    --numInfs;
+                } else {
+                    double density = (*inf)->getDensity();
+                    totalDensity += density;
+                    if( !(*inf)->isHrp2Deficient() ){
+                        hrp2Density += density;
+                    }
+                    timeStepMaxDensity = max(timeStepMaxDensity, density);
+                    if( density > 0 ){
+                        // Base 10 logarithms are usually used; +1 because it avoids negatives in output while having very little affect on high densities
+                        sumLogDens += log10(1.0 + density);
+                    }
+                    *kept++ = *inf;
                 }
-                ++inf;
             }
+            infections.erase( kept, infections.end() );
+            pkpdModel.decayDrugs (body_mass);
         }
-        pkpdModel.decayDrugs (body_mass);
     }
     
     // As in AJTMH p22, cumulative_h (X_h + 1) doesn't include infections added
@@ -254,20 +263,7 @@ void CommonWithinHost::update(Host::Human &human, LocalRng& rng, int &nNewInfs_i
     assert( (std::isfinite)(totalDensity) );        // inf probably wouldn't be a problem but NaN would be
     
     // Cache total density for infectiousness calculations
-    int y_lag_i = sim::moduloSteps(sim::ts1(), y_lag_len);
-    for( size_t g = 0; g < Genotypes::N(); ++g )
-    {
-        m_y_lag_i[y_lag_i * Genotypes::N() + g] = 0.0;
-        m_y_lag_l[y_lag_i * Genotypes::N() + g] = 0.0;
-    }
-
-    for( auto inf = infections.begin(); inf != infections.end(); ++inf )
-    {
-        if((*inf)->origin() == InfectionOrigin::Imported)
-            m_y_lag_i[y_lag_i * Genotypes::N() + (*inf)->genotype()] += (*inf)->getDensity();
-        else
-            m_y_lag_l[y_lag_i * Genotypes::N() + (*inf)->genotype()] += (*inf)->getDensity();
-    }
+    setLagDensities( infections );
 
     // This is a bug, we keep it this way to be consistent with old simulations
     if(nNewInfsIgnored > 0)
@@ -286,8 +282,8 @@ InfectionOrigin CommonWithinHost::getInfectionOrigin()const
 
 // -----  Summarize  -----
 
-// Used in summarizeInfs.
-vector<CommonInfection*> sortedInfs;
+// Used in summarizeInfs (one per thread since humans may be updated in parallel).
+thread_local vector<CommonInfection*> sortedInfs;
 struct InfGenotypeSorter {
     bool operator() (CommonInfection* i, CommonInfection* j){
         return i->genotype() < j->genotype();
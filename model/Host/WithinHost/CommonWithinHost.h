@@ -88,9 +88,13 @@ private:
     /** The list of all infections this human has.
      *
      * Since infection models and within host models are very much intertwined,
-     * the idea is that each WithinHostModel has its own list of infections. */
+     * the idea is that each WithinHostModel has its own list of infections.
+     * 
+     * There are at most MAX_INFECTIONS, so a vector (kept in order of
+     * creation) is cheaper than a linked list. The infections themselves are
+     * allocated from a pool (see util::ObjectPool). */
     //TODO: better to template class over infection type than use dynamic type?
-    std::list<CommonInfection*> infections;
+    std::vector<CommonInfection*> infections;
 
     bool opt_vaccine_genotype = false;
 };
@@ -214,21 +214,7 @@ void DescriptiveWithinHostModel::update(Host::Human &human, LocalRng& rng, int &
     assert( (std::isfinite)(totalDensity) );        // inf probably wouldn't be a problem but NaN would be
     
     // Cache total density for infectiousness calculations
-    int y_lag_i = sim::moduloSteps(sim::ts1(), y_lag_len);
-
-    for( size_t g = 0; g < Genotypes::N(); ++g )
-    {
-        m_y_lag_i[y_lag_i * Genotypes::N() + g] = 0.0;
-        m_y_lag_l[y_lag_i * Genotypes::N() + g] = 0.0;
-    }
-
-    for( auto inf = infections.begin(); inf != infections.end(); ++inf )
-    {
-        if((*inf)->origin() == InfectionOrigin::Imported)
-            m_y_lag_i[y_lag_i * Genotypes::N() + (*inf)->genotype()] += (*inf)->getDensity();
-        else
-            m_y_lag_l[y_lag_i * Genotypes::N() + (*inf)->genotype()] += (*inf)->getDensity();
-    }
+    setLagDensities( infections );
 
     // This is a bug, we keep it this way to be consistent with old simulations
     if(opt_vaccine_genotype == false)
@@ -25,6 +25,7 @@
 
 #include "Host/WithinHost/Infection/Infection.h"
 #include "util/random.h"
+#include "util/ObjectPool.h"
 
 namespace OM { namespace WithinHost {
 
@@ -51,7 +52,7 @@ const double maxDens = 2000000;
  * Note that this class models only a single infection; for the associated
  * handling of multiple infections see the DescriptiveWithinHostModel class.
  */
-class DescriptiveInfection : public Infection {
+class DescriptiveInfection : public Infection, public util::Pooled<DescriptiveInfection> {
 public:
     ///@name Static init/cleanup
     //@{
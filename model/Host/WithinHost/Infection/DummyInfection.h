@@ -24,6 +24,7 @@
 #define Hmod_DummyInfection
 
 #include "Host/WithinHost/Infection/CommonInfection.h"
+#include "util/ObjectPool.h"
 
 namespace OM { namespace WithinHost {
 
@@ -34,7 +35,7 @@ CommonInfection* createDummyInfection (LocalRng& rng, uint32_t protID, int origi
 /*!
   Models related to the within-host dynamics of infections.
 */
-class DummyInfection : public CommonInfection {
+class DummyInfection : public CommonInfection, public util::Pooled<DummyInfection> {
 public:
     /// For checkpointing (don't use for anything else)
     DummyInfection (istream& stream);
@@ -24,10 +24,11 @@
 #define Hmod_EmpiricalInfection
 
 #include "Host/WithinHost/Infection/CommonInfection.h"
+#include "util/ObjectPool.h"
 
 namespace OM { namespace WithinHost {
     
-class EmpiricalInfection : public CommonInfection {
+class EmpiricalInfection : public CommonInfection, public util::Pooled<EmpiricalInfection> {
 public:
   ///@brief Static methods
   //@{
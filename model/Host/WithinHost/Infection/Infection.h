@@ -155,8 +155,9 @@ protected:
     friend class ::UnittestUtil;
 };
 
-template <typename T>
-InfectionOrigin get_infection_origin(const std::list<T*> &infections)
+/// Origin of a host's infections (infections: a list or vector of pointers)
+template <typename Container>
+InfectionOrigin get_infection_origin(const Container &infections)
 {
     if(infections.empty())
         return InfectionOrigin::Indigenous;
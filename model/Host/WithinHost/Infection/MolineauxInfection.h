@@ -24,6 +24,7 @@
 #define Hmod_MOLINEAUXINFECTION_H
 
 #include "Host/WithinHost/Infection/CommonInfection.h"
+#include "util/ObjectPool.h"
 
 class MolineauxInfectionSuite;
 
@@ -37,7 +38,7 @@ namespace OM { namespace WithinHost {
  * mathematical model. Parasitology, 122, pp 379-391
  * doi:10.1017/S0031182001007533
  */
-class MolineauxInfection : public CommonInfection {
+class MolineauxInfection : public CommonInfection, public util::Pooled<MolineauxInfection> {
 public:
     ///@brief Static class members
     //@{
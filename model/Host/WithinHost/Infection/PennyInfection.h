@@ -27,12 +27,13 @@
 #define Hmod_PENNYINFECTION_H
 
 #include "Host/WithinHost/Infection/CommonInfection.h"
+#include "util/ObjectPool.h"
 
 class PennyInfectionSuite;
 
 namespace OM { namespace WithinHost {
 
-class PennyInfection : public CommonInfection {
+class PennyInfection : public CommonInfection, public util::Pooled<PennyInfection> {
 public:
     /// Static initialization (happens once)
     static void init();
@@ -135,16 +135,14 @@ WHFalciparum::WHFalciparum( LocalRng& rng, double comorbidityFactor ):
     m_cumulative_h(0.0), m_cumulative_Y(0.0), m_cumulative_Y_lag(0.0),
     totalDensity(0.0), hrp2Density(0.0), timeStepMaxDensity(0.0),
     pathogenesisModel( Pathogenesis::PathogenesisModel::createPathogenesisModel( comorbidityFactor ) ),
-    treatExpiryLiver(0), treatExpiryBlood(0)
+    treatExpiryLiver(0), treatExpiryBlood(0),
+    m_pTransmitTime(sim::never()), m_pTransmit(0.0)
 {
     // NOTE: negating a Gaussian sample with mean 0 is pointless — except that
     // the individual samples change. In any case the overhead is negligible.
     //FIXME: Should this be allowed to be greater than 1?
     // Oldest code on GoogleCode: _innateImmunity=(double)(W_GAUSS((0), (sigma_i)));
     _innateImmSurvFact = exp(-rng.gauss(0.0, sigma_i));
-    
-    m_y_lag_i.resize(y_lag_len * Genotypes::N());
-    m_y_lag_l.resize(y_lag_len * Genotypes::N());
 }
 
 WHFalciparum::~WHFalciparum()
@@ -182,44 +180,92 @@ const double PTM_tau= 0.066;
 const double PTM_tau_prime = 1.0 / sqrt(1.0 / PTM_tau);
 const double PTM_mu= -8.1;
 
-inline double compute_y_lag(const vector<double> &y_lag, int y_lag_len, vector<double> &y_lag_g)
-{
-    const size_t n = Genotypes::N();
+/// Lagged densities of one genotype (weighted sum, imported and local)
+struct GenotypeLag{
+    uint32_t genotype;
+    double y_i[3], y_l[3];      // 10, 15 and 20 days ago
+};
 
-    // Take weighted sum of total asexual blood stage density 10, 15 and 20 days
-    // before. Add y_lag_len to index to ensure positive.
-    size_t d10 = mod_nn(y_lag_len + sim::inSteps(sim::ts1() - sim::fromDays(10)), y_lag_len);
-    size_t d15 = mod_nn(y_lag_len + sim::inSteps(sim::ts1() - sim::fromDays(15)), y_lag_len);
-    size_t d20 = mod_nn(y_lag_len + sim::inSteps(sim::ts1() - sim::fromDays(20)), y_lag_len);
+/** Collect densities from 10, 15 and 20 days before ts1() into y_lag_g, in
+ * order of genotype. Genotypes absent from all three steps are omitted. */
+inline void collect_y_lag(const vector<LagDensity> &y_lag, int y_lag_len, vector<GenotypeLag> &y_lag_g)
+{
+    // Add y_lag_len to index to ensure positive.
+    const uint32_t slots[3] = {
+        static_cast<uint32_t>(mod_nn(y_lag_len + sim::inSteps(sim::ts1() - sim::fromDays(10)), y_lag_len)),
+        static_cast<uint32_t>(mod_nn(y_lag_len + sim::inSteps(sim::ts1() - sim::fromDays(15)), y_lag_len)),
+        static_cast<uint32_t>(mod_nn(y_lag_len + sim::inSteps(sim::ts1() - sim::fromDays(20)), y_lag_len))
+    };
+    
+    y_lag_g.clear();
+    for( const LagDensity& e : y_lag ){
+        for( int j = 0; j < 3; ++j ){
+            if( e.slot != slots[j] ) continue;
+            auto it = y_lag_g.begin();
+            while( it != y_lag_g.end() && it->genotype != e.genotype ) ++it;
+            if( it == y_lag_g.end() ){
+                y_lag_g.push_back( GenotypeLag{ e.genotype, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0} } );
+                it = y_lag_g.end() - 1;
+            }
+            it->y_i[j] = e.y_i;
+            it->y_l[j] = e.y_l;
+        }
+    }
+    std::sort( y_lag_g.begin(), y_lag_g.end(),
+        []( const GenotypeLag& a, const GenotypeLag& b ){ return a.genotype < b.genotype; } );
+}
 
+/** Take weighted sum of total asexual blood stage density 10, 15 and 20 days
+ * before, over genotypes (y is GenotypeLag::y_i or y_l). Sums are taken in
+ * order of genotype; omitted genotypes would only add zeros. */
+inline double sum_y_lag(const vector<GenotypeLag> &y_lag_g, double (GenotypeLag::*y)[3])
+{
     double y10_sum = 0.0, y15_sum = 0.0, y20_sum = 0.0;
-    for( size_t g = 0; g < n; ++g ){
-        double y10 = y_lag[d10 * n + g];
-        double y15 = y_lag[d15 * n + g];
-        double y20 = y_lag[d20 * n + g];
-        y10_sum += y10;
-        y15_sum += y15;
-        y20_sum += y20;
-        y_lag_g[g] = PTM_beta1 * y10 + PTM_beta2 * y15 + PTM_beta3 * y20;
+    for( const GenotypeLag& lag : y_lag_g ){
+        y10_sum += (lag.*y)[0];
+        y15_sum += (lag.*y)[1];
+        y20_sum += (lag.*y)[2];
     }
-    
-    // Weighted sum:
     return PTM_beta1 * y10_sum + PTM_beta2 * y15_sum + PTM_beta3 * y20_sum;
 }
 
-double WHFalciparum::probTransmissionToMosquito(vector<double> &probTransGenotype_i, vector<double> &probTransGenotype_l) const{
+/// Weighted density of one genotype
+inline double weight_y_lag(const double (&y)[3])
+{
+    return PTM_beta1 * y[0] + PTM_beta2 * y[1] + PTM_beta3 * y[2];
+}
+
+double WHFalciparum::probTransmissionToMosquito(vector<GenotypeTransmission> &probTransGenotype) const{
+    // This is called by both VectorModel::vectorUpdate and
+    // TransmissionModel::updateKappa each step. The result depends only on
+    // densities 10, 15 and 20 days before sim::ts1(), while update() only
+    // writes densities for sim::ts1(), so it is calculated once per step.
+    if( m_pTransmitTime != sim::ts1() ){
+        m_pTransmit = calcProbTransmissionToMosquito();
+        m_pTransmitTime = sim::ts1();
+    }
+    if( m_pTransmit <= 0.0 ){
+        probTransGenotype.clear();
+        return m_pTransmit;
+    }
+    probTransGenotype.assign( m_pTransmitGenotype.begin(), m_pTransmitGenotype.end() );
+    return m_pTransmit;
+}
+
+double WHFalciparum::calcProbTransmissionToMosquito() const{
     // This model (often referred to as the gametocyte model) was designed for
     // 5-day time steps. We use the same model (sampling 10, 15 and 20 days
     // ago) for 1-day time steps to avoid having to design and analyse a new
     // model. Description: AJTMH pp.32-33 and p9.
     
     // Note: we don't allow for gametocydal treatments (e.g. Primaquine).
-    const size_t n = Genotypes::N();
 
-    // Sum lagged densities across genotypes:
-    vector<double> y_lag_g_i(n), y_lag_g_l(n);
-    const double y_lag_sum_i = compute_y_lag(m_y_lag_i, y_lag_len, y_lag_g_i);
-    const double y_lag_sum_l = compute_y_lag(m_y_lag_l, y_lag_len, y_lag_g_l);
+    // Lagged densities of genotypes present (scratch space: one per thread,
+    // reused between calls; collect_y_lag clears it):
+    thread_local vector<GenotypeLag> y_lag_g;
+    collect_y_lag(m_y_lag, y_lag_len, y_lag_g);
+    const double y_lag_sum_i = sum_y_lag(y_lag_g, &GenotypeLag::y_i);
+    const double y_lag_sum_l = sum_y_lag(y_lag_g, &GenotypeLag::y_l);
     const double y_lag_sum = y_lag_sum_i + y_lag_sum_l;
 
     if( y_lag_sum < 0.001 ) return 0.0; // cut off for uninfectious humans
@@ -236,10 +282,12 @@ double WHFalciparum::probTransmissionToMosquito(vector<double> &probTransGenotyp
     if(pTransmit <= 0.0)
         return pTransmit;
 
-    for( size_t g = 0; g < n; ++g )
+    m_pTransmitGenotype.clear();
+    for( const GenotypeLag& lag : y_lag_g )
     {
-        probTransGenotype_i[g] = pTransmit * y_lag_g_i[g] / y_lag_sum;
-        probTransGenotype_l[g] = pTransmit * y_lag_g_l[g] / y_lag_sum;
+        m_pTransmitGenotype.push_back( GenotypeTransmission{ lag.genotype,
+            pTransmit * weight_y_lag(lag.y_i) / y_lag_sum,
+            pTransmit * weight_y_lag(lag.y_l) / y_lag_sum } );
     }
 
     // Include here the effect of transmission-blocking vaccination:
@@ -325,11 +373,11 @@ void WHFalciparum::checkpoint (istream& stream) {
     totalDensity & stream;
     hrp2Density & stream;
     timeStepMaxDensity & stream;
-    m_y_lag_i & stream;
-    m_y_lag_l & stream;
+    m_y_lag & stream;
     (*pathogenesisModel) & stream;
     treatExpiryLiver & stream;
     treatExpiryBlood & stream;
+    m_pTransmitTime = sim::never();
 }
 void WHFalciparum::checkpoint (ostream& stream) {
     WHInterface::checkpoint( stream );
@@ -340,8 +388,7 @@ void WHFalciparum::checkpoint (ostream& stream) {
     totalDensity & stream;
     hrp2Density & stream;
     timeStepMaxDensity & stream;
-    m_y_lag_i & stream;
-    m_y_lag_l & stream;
+    m_y_lag & stream;
     (*pathogenesisModel) & stream;
     treatExpiryLiver & stream;
     treatExpiryBlood & stream;
@@ -34,6 +34,7 @@
 using namespace std;
 
 class InfectionImmunitySuite;
+class AllocationSuite;
 
 namespace OM {
 namespace WithinHost {
@@ -41,6 +42,22 @@ namespace Pathogenesis {
     class PathogenesisModel;
 }
 
+/// Parasite density of one genotype at the end of one time step
+struct LagDensity{
+    uint32_t slot;          // time step modulo WHFalciparum::y_lag_len
+    uint32_t genotype;
+    double y_i, y_l;        // imported and local infections
+    
+    /// Checkpointing
+    template<class S>
+    void operator& (S& stream) {
+        slot & stream;
+        genotype & stream;
+        y_i & stream;
+        y_l & stream;
+    }
+};
+
 /**
  * Immunity code and base class for all current P. falciparum models.
  */
@@ -58,7 +75,7 @@ public:
     virtual ~WHFalciparum();
     //@}
     
-    virtual double probTransmissionToMosquito(vector<double> &probTransGenotype_i, vector<double> &probTransGenotype_l)const;
+    virtual double probTransmissionToMosquito(vector<GenotypeTransmission> &probTransGenotype)const;
 
     // No PQ treatment for falciparum in current models:
     virtual void optionalPqTreatment( Host::Human& human ){}
@@ -126,11 +143,38 @@ protected:
     double timeStepMaxDensity;
     
     /** Total asexual blood stage density over last 20 days (uses samples from
-    * 10, 15 and 20 days ago).
+    * 10, 15 and 20 days ago), for imported and local infections.
     *
-    * m_y_lag[sim::ts0().moduloSteps(y_lag_len)] corresponds to the density
-    * from the previous time step (once updateInfection has been called). */
-    std::vector<double> m_y_lag_i, m_y_lag_l;
+    * Sparse: only genotypes present in some infection are listed. Entries
+    * with slot sim::moduloSteps(t, y_lag_len) hold densities at the end of
+    * step t; entries of one slot are contiguous and in order of genotype.
+    * Entries with slot sim::ts0().moduloSteps(y_lag_len) correspond to the
+    * density from the previous time step (once update has been called). */
+    std::vector<LagDensity> m_y_lag;
+    
+    /** Replace entries of m_y_lag for the step ending at ts1() with the
+     * densities of infections (called at the end of update). */
+    template<class Infections>
+    void setLagDensities( const Infections& infections ){
+        const uint32_t slot = sim::moduloSteps(sim::ts1(), y_lag_len);
+        util::vectors::compact( m_y_lag, [slot]( const LagDensity& e ){ return e.slot == slot; } );
+        const size_t first = m_y_lag.size();
+        for( auto inf = infections.begin(); inf != infections.end(); ++inf ){
+            const uint32_t genotype = (*inf)->genotype();
+            auto e = m_y_lag.begin() + first;
+            while( e != m_y_lag.end() && e->genotype != genotype ) ++e;
+            if( e == m_y_lag.end() ){
+                m_y_lag.push_back( LagDensity{ slot, genotype, 0.0, 0.0 } );
+                e = m_y_lag.end() - 1;
+            }
+            if((*inf)->origin() == InfectionOrigin::Imported)
+                e->y_i += (*inf)->getDensity();
+            else
+                e->y_l += (*inf)->getDensity();
+        }
+        std::sort( m_y_lag.begin() + first, m_y_lag.end(),
+            []( const LagDensity& a, const LagDensity& b ){ return a.genotype < b.genotype; } );
+    }
     
     /// The PathogenesisModel introduces illness dependant on parasite density
     unique_ptr<Pathogenesis::PathogenesisModel> pathogenesisModel;
@@ -141,12 +185,23 @@ protected:
     virtual void checkpoint (istream& stream);
     virtual void checkpoint (ostream& stream);
 
-    /// Length of m_y_lag array. Wouldn't have to be dynamic if Global::interval was known at compile-time.
+    /// Calculate probTransmissionToMosquito, setting m_pTransmitGenotype
+    double calcProbTransmissionToMosquito() const;
+    
+    /** Cache of probTransmissionToMosquito: value for the step ending at
+     * m_pTransmitTime, and when positive, per-genotype probabilities. Not
+     * checkpointed. */
+    mutable SimTime m_pTransmitTime;
+    mutable double m_pTransmit;
+    mutable std::vector<GenotypeTransmission> m_pTransmitGenotype;
+
+    /// Number of time steps covered by m_y_lag. Wouldn't have to be dynamic if Global::interval was known at compile-time.
     /// set by initHumanParameters
     static int y_lag_len;
     
     static void setParams(double cumYStar, double cumHStar, double aM, double dM);   // for unit test only
     friend class ::InfectionImmunitySuite;
+    friend class ::AllocationSuite;
 };
 
 }
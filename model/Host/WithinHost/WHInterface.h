@@ -48,6 +48,13 @@ namespace WithinHost {
 
 using util::LocalRng;
 
+/** Probability of infecting a feeding mosquito with one genotype, from
+ * imported (_i) and local (_l) infections. */
+struct GenotypeTransmission{
+    uint32_t genotype;
+    double prob_i, prob_l;
+};
+
 /**
  * Type used to select a treatment option.
  * 
@@ -109,13 +116,13 @@ public:
      * 
      * @returns the probability of this human infecting a feeding mosquito.
      * 
-     * Calculates the probability of transmitting an infection of a given
-     * genotype to a mosquito and store the result in probTransGenotype[g]
-     * for a given genotype g 
-     * 
-     * Calulates the probability for imported infections _i and
-     * for local infections _l */
-    virtual double probTransmissionToMosquito(vector<double> &probTransGenotype_i, vector<double> &probTransGenotype_l)const = 0;
+     * Also calculates the probability of transmitting an infection of each
+     * genotype to a mosquito, for imported and for local infections.
+     * probTransGenotype is set to a list of these in order of genotype;
+     * genotypes not listed have probability zero. The list only covers
+     * genotypes recently present in this human, so its length does not
+     * depend on the total number of genotypes. */
+    virtual double probTransmissionToMosquito(vector<GenotypeTransmission> &probTransGenotype)const = 0;
 
     /// @returns true if host has patent parasites
     virtual bool summarize(Host::Human& human) const =0;
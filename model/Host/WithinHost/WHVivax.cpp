@@ -329,8 +329,9 @@ WHVivax::~WHVivax(){
 
 
 
-double WHVivax::probTransmissionToMosquito(vector<double> &probTransGenotype_i, vector<double> &probTransGenotype_l)const{
+double WHVivax::probTransmissionToMosquito(vector<GenotypeTransmission> &probTransGenotype)const{
     assert( WithinHost::Genotypes::N() == 1 );
+    probTransGenotype.clear();
     for(auto inf = infections.begin();
          inf != infections.end(); ++inf)
     {
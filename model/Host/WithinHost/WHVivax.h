@@ -152,7 +152,7 @@ public:
     virtual ~WHVivax();
     //@}
     
-    virtual double probTransmissionToMosquito(vector<double> &probTransGenotype_i, vector<double> &probTransGenotype_l)const;
+    virtual double probTransmissionToMosquito(vector<GenotypeTransmission> &probTransGenotype)const;
     
     virtual bool summarize(Host::Human& human) const;
     
@@ -22,6 +22,7 @@
 
 #include "PkPd/Drug/LSTMDrug.h"
 #include "util/errors.h"
+#include "util/CommandLine.h"
 #include "util/StreamValidator.h"
 #include "util/vectors.h"
 
@@ -54,6 +55,22 @@ void LSTMDrug::medicate(double time, double qty){
     auto pos = lower_bound(doses.begin(), doses.end(), elt, comp);
     doses.insert(pos, move(elt));
     assert(is_sorted(doses.begin(), doses.end(), comp));
+    factorCache.clear();
+}
+
+bool LSTMDrug::cachedFactor( const FactorKey& key, double& factor ) const{
+    for( const auto& entry : factorCache ){
+        if( entry.first == key ){
+            factor = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+void LSTMDrug::cacheFactor( const FactorKey& key, double factor ) const{
+    if( util::CommandLine::option(util::CommandLine::PKPD_QAG) ) return;
+    factorCache.push_back( make_pair(key, factor) );
 }
 
 }
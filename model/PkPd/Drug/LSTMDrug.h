@@ -27,6 +27,8 @@
 #include "util/checkpoint_containers.h"
 #include "util/random.h"
 
+#include <array>
+
 namespace OM {
 namespace WithinHost {
     class CommonInfection;
@@ -89,12 +91,28 @@ public:
     void operator& (S& stream) {
         doses & stream;
         checkpoint(stream);
+        factorCache.clear();
     }
 
 protected:
     virtual void checkpoint (istream& stream){}
     virtual void checkpoint (ostream& stream){}
     
+    /// Body mass and killing parameters of a drug factor (unused entries zero)
+    typedef std::array<double, 7> FactorKey;
+    
+    /** Get a drug factor calculated earlier today with identical key, e.g.
+     * for another infection of the same genotype in the same host.
+     * 
+     * @returns false if there is none (or caching is disabled) */
+    bool cachedFactor( const FactorKey& key, double& factor ) const;
+    /// Save a drug factor for use by cachedFactor until doses or concentrations change
+    void cacheFactor( const FactorKey& key, double factor ) const;
+    
+    /** Drug factors calculated today (see cachedFactor). Cleared by medicate()
+     * and when updating concentrations; not checkpointed. */
+    mutable std::vector<std::pair<FactorKey, double>> factorCache;
+    
     /// First is time (days), second is additional concentration (mg / l; for
     /// one- and three-compartment models) or quantity (mg; for conversion model)
     typedef std::vector<std::pair<double,double> > DoseVec;
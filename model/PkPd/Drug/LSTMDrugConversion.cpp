@@ -21,12 +21,13 @@
  */
 
 #include "PkPd/Drug/LSTMDrugConversion.h"
+#include "PkPd/Drug/Quadrature.h"
 #include "Host/WithinHost/Infection/CommonInfection.h"
+#include "util/CommandLine.h"
 #include "util/errors.h"
 #include "util/StreamValidator.h"
 #include "util/vectors.h"
 
-#include <gsl/gsl_integration.h>
 #include <limits>
 
 using namespace std;
@@ -115,43 +116,37 @@ double calculateMetaboliteDrugFactor( struct Params_convFactor p, double expAbso
 // size_t intg_steps = 0;
 /** Function for calculating concentration and then killing function at time t
  * 
+ * @param p Parameters
  * @param t The variable being integrated over (in this case, time since start
  *      of day or last dose, units days)
- * @param pp Pointer to a Params_convFactor struct
  * @return killing rate (unitless)
  */
-double func_convFactor( double t, void* pp ){
+inline double convFactor( const Params_convFactor& p, double t ){
 //     intg_steps += 1;
-    const Params_convFactor& p = *static_cast<const Params_convFactor*>( pp );
     const double expAbsorb = exp(p.nka * t), expPLoss = exp(p.nl * t);
     const double fCP = calculateParentDrugFactor( p, expAbsorb, expPLoss );
     const double fCM = calculateMetaboliteDrugFactor( p, expAbsorb, expPLoss, t );
     // use the most effective killing factor (from area under the drug kill curve), which is the one with the bigger number
     return max(fCP,fCM);
 }
+/// convFactor for GSL; pp is a pointer to a Params_convFactor struct
+double func_convFactor( double t, void* pp ){
+    return convFactor( *static_cast<const Params_convFactor*>( pp ), t );
+}
 
-const size_t GSL_INTG_CONV_MAX_ITER = 1000;     // 10 seems enough, but no harm in using a higher value
-gsl_integration_workspace *gsl_intgr_conv_wksp = gsl_integration_workspace_alloc (GSL_INTG_CONV_MAX_ITER);
-//NOTE: we "should" free, but mem-leaks at end of program aren't really important
-// gsl_integration_workspace_free (gsl_intgr_conv_wksp);
 double LSTMDrugConversion::calculateFactor(const Params_convFactor& p, double duration) const{
-    gsl_function F;
-    F.function = &func_convFactor;
-    // gsl_function doesn't accept const; we re-apply const later
-    F.params = static_cast<void*>(const_cast<Params_convFactor*>(&p));
-    
     // We use exp(-result), so small absolute differences can matter (but also
     // using smaller abs_eps is cheap). We likely don't need high rel precision.
     const double abs_eps = 1e-5, rel_eps = 1e-2;
-    // NOTE: 1 through 6 are different algorithms of increasing complexity
-    const int qag_rule = 1;     // alg 1 seems to be good enough
     double intfC, err_eps;      // intfC will carry our result; err_eps is a measure of accuracy of the result
     
 //     intg_steps = 0;
-    int r = gsl_integration_qag (&F, 0.0, duration, abs_eps, rel_eps,
-                                 GSL_INTG_CONV_MAX_ITER, qag_rule, gsl_intgr_conv_wksp, &intfC, &err_eps);
-    if( r != 0 ){
-        throw TRACED_EXCEPTION( "calculateFactor: error from gsl_integration_qag",util::Error::GSL );
+    // Usually QAG's first step suffices; do that directly (see integrateGK15)
+    const bool useQag = util::CommandLine::option(util::CommandLine::PKPD_QAG);
+    if( useQag || !integrateGK15( [&p]( double t ){ return convFactor( p, t ); },
+            0.0, duration, abs_eps, rel_eps, intfC, err_eps ) )
+    {
+        integrateQag(&func_convFactor, &p, 0.0, duration, abs_eps, rel_eps, intfC, err_eps);
     }
     // Testing err_eps is redundant with GSL's built-in tests
 //     cout << "integration steps: " << intg_steps << endl;
@@ -222,6 +217,11 @@ double LSTMDrugConversion::calculateDrugFactor(LocalRng& rng, WithinHost::Common
     setConversionParameters(p, body_mass);
     setKillingParameters(rng, p, inf);
     
+    // Infections with the same PD parameters get the same factor
+    const FactorKey key = {{ body_mass, p.nP, p.VP, p.KnP, p.nM, p.VM, p.KnM }};
+    double factor;
+    if( cachedFactor(key, factor) ) return factor;
+    
     double time = 0.0;  // time since start of day
     double totalFactor = 1.0;   // survival factor for whole day
     
@@ -248,10 +248,12 @@ double LSTMDrugConversion::calculateDrugFactor(LocalRng& rng, WithinHost::Common
         totalFactor *= calculateFactor(p, 1.0 - time);
     }
     
+    cacheFactor(key, totalFactor);
     return totalFactor;
 }
 
 void LSTMDrugConversion::updateConcentration( double body_mass ){
+    factorCache.clear();
     if( qtyG == 0.0 && qtyP == 0.0 && qtyM == 0.0 && doses.size() == 0 ){
         return; // nothing to do
     }
@@ -21,11 +21,12 @@
  */
 
 #include "PkPd/Drug/LSTMDrugThreeComp.h"
+#include "PkPd/Drug/Quadrature.h"
 #include "Host/WithinHost/Infection/CommonInfection.h"
+#include "util/CommandLine.h"
 #include "util/errors.h"
 #include "util/StreamValidator.h"
 
-#include <gsl/gsl_integration.h>
 #include <limits>
 
 using namespace std;
@@ -105,14 +106,12 @@ struct Params_fC {
 };
 /** Function for calculating concentration and then killing function at time t
  * 
+ * @param p Parameters
  * @param t The variable being integrated over (in this case, time since start
  *      of day or last dose, units days)
- * @param pp Pointer to a Params_fC struct
  * @return killing rate (unitless)
  */
-double func_fC( double t, void* pp ){
-    const Params_fC& p = *static_cast<const Params_fC*>( pp );
-    
+inline double fC( const Params_fC& p, double t ){
     // exponential decay of drug concentration:
     const double concA = p.cA * exp(p.na * t);
     const double concB = p.cB * exp(p.nb * t);
@@ -124,27 +123,21 @@ double func_fC( double t, void* pp ){
     const double fC = p.V * cn / (cn + p.Kn);       // unitless
     return fC;
 }
-const size_t GSL_INTG_MAX_ITER = 1000;     // 10 seems enough, but no harm in using a higher value
-gsl_integration_workspace *gsl_intgr_wksp = gsl_integration_workspace_alloc (GSL_INTG_MAX_ITER);
-//NOTE: we "should" free, but mem-leaks at end of program aren't really important
-// gsl_integration_workspace_free (gsl_intgr_wksp);
-
+/// fC for GSL; pp is a pointer to a Params_fC struct
+double func_fC( double t, void* pp ){
+    return fC( *static_cast<const Params_fC*>( pp ), t );
+}
 double LSTMDrugThreeComp::calculateFactor(const Params_fC& p, double duration) const{
-    gsl_function F;
-    F.function = &func_fC;
-    // gsl_function doesn't accept const; we re-apply const later
-    F.params = static_cast<void*>(const_cast<Params_fC*>(&p));
-    
     // NOTE: tolerances are arbitrary, but seem to be sufficient
     const double abs_eps = 1e-4, rel_eps = 1e-4;
-    // NOTE: 1 through 6 are different algorithms of increasing complexity
-    const int qag_rule = 1;     // alg 1 seems to be good enough
     double intfC, err_eps;
     
-    int r = gsl_integration_qag (&F, 0.0, duration, abs_eps, rel_eps,
-                                 GSL_INTG_MAX_ITER, qag_rule, gsl_intgr_wksp, &intfC, &err_eps);
-    if( r != 0 ){
-        throw TRACED_EXCEPTION( "calculateFactor: error from gsl_integration_qag",util::Error::GSL );
+    // Usually QAG's first step suffices; do that directly (see integrateGK15)
+    const bool useQag = util::CommandLine::option(util::CommandLine::PKPD_QAG);
+    if( useQag || !integrateGK15( [&p]( double t ){ return fC( p, t ); },
+            0.0, duration, abs_eps, rel_eps, intfC, err_eps ) )
+    {
+        integrateQag(&func_fC, &p, 0.0, duration, abs_eps, rel_eps, intfC, err_eps);
     }
     if( err_eps > 5e-2 ){
         // This could be a warning, except that warnings tend to be ignored.
@@ -169,6 +162,11 @@ double LSTMDrugThreeComp::calculateDrugFactor(LocalRng& rng, WithinHost::CommonI
     p.n = pd.slope();   p.V = pd.max_killing_rate();
     p.Kn = pd.IC50_pow_slope(rng, typeData.getIndex(), inf);
     
+    // Infections with the same PD parameters get the same factor
+    const FactorKey key = {{ body_mass, p.n, p.V, p.Kn, 0.0, 0.0, 0.0 }};
+    double factor;
+    if( cachedFactor(key, factor) ) return factor;
+    
     double time = 0.0;  // time since start of day
     double totalFactor = 1.0;   // survival factor for whole day
     
@@ -198,10 +196,12 @@ double LSTMDrugThreeComp::calculateDrugFactor(LocalRng& rng, WithinHost::CommonI
         totalFactor *= calculateFactor(p, 1.0 - time);
     }
     
+    cacheFactor(key, totalFactor);
     return totalFactor;
 }
 
 void LSTMDrugThreeComp::updateConcentration (double body_mass) {
+    factorCache.clear();
     if( conc() == 0.0 && doses.size() == 0 ) return;     // nothing to do
     updateCached(body_mass);
     
@@ -0,0 +1,66 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2025 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2025 University of Basel
+ * Copyright (C) 2025 The Kids Research Institute Australia
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#include "PkPd/Drug/Quadrature.h"
+#include "util/errors.h"
+
+#include <gsl/gsl_integration.h>
+#include <memory>
+
+namespace OM {
+namespace PkPd {
+
+const size_t QAG_MAX_ITER = 1000;     // 10 seems enough, but no harm in using a higher value
+
+struct WorkspaceDeleter {
+    void operator()( gsl_integration_workspace *w ) const {
+        gsl_integration_workspace_free( w );
+    }
+};
+
+void integrateQag(double (*f)(double, void*), const void* params,
+        double a, double b, double epsabs, double epsrel,
+        double& result, double& abserr)
+{
+    // One workspace per thread (humans may be updated in parallel); allocated
+    // on first use and freed on thread exit
+    thread_local unique_ptr<gsl_integration_workspace, WorkspaceDeleter> workspace;
+    if( !workspace ) workspace.reset( gsl_integration_workspace_alloc( QAG_MAX_ITER ) );
+    
+    gsl_function F;
+    F.function = f;
+    // gsl_function doesn't accept const; f re-applies const
+    F.params = const_cast<void*>(params);
+    
+    // NOTE: 1 through 6 are different algorithms of increasing complexity
+    const int qag_rule = GSL_INTEG_GAUSS15;     // seems to be good enough (integrateGK15 assumes this)
+    
+    int r = gsl_integration_qag( &F, a, b, epsabs, epsrel, QAG_MAX_ITER,
+            qag_rule, workspace.get(), &result, &abserr );
+    if( r != 0 ){
+        throw TRACED_EXCEPTION( "integrateQag: error from gsl_integration_qag", util::Error::GSL );
+    }
+}
+
+}
+}
@@ -0,0 +1,157 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2025 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2025 University of Basel
+ * Copyright (C) 2025 The Kids Research Institute Australia
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef Hmod_PkPd_Quadrature
+#define Hmod_PkPd_Quadrature
+
+#include <cmath>
+#include <cfloat>
+
+namespace OM {
+namespace PkPd {
+
+/** Integrate f over [a, b] with the 15-point Gauss-Kronrod rule, exactly as
+ * the first step of gsl_integration_qag with key GSL_INTEG_GAUSS15 does
+ * (same nodes, same order of operations and the same acceptance test), but
+ * with f called directly (and usually inlined) and without a workspace.
+ *
+ * Drug concentrations are smooth over a day, so QAG almost always accepts
+ * this first step. The result, error estimate and decision are then those of
+ * QAG, provided the compiler evaluates them as GSL's build does (e.g. the
+ * same FMA contraction); PkPdComplianceSuite::testIntegrateGK15 checks this
+ * against the GSL linked. --pkpd-qag always uses QAG.
+ *
+ * @returns true if QAG would return this result without subdividing the
+ *  interval. Otherwise the caller should call integrateQag. */
+template<class F>
+bool integrateGK15(const F& f, double a, double b, double epsabs, double epsrel,
+        double& result, double& abserr)
+{
+    // Abscissae and weights from QUADPACK (as in GSL's qk15.c)
+    static const double xgk[8] = {
+        0.991455371120812639206854697526329,
+        0.949107912342758524526189684047851,
+        0.864864423359769072789712788640926,
+        0.741531185599394439863864773280788,
+        0.586087235467691130294144845693013,
+        0.405845151377397166906606412076961,
+        0.207784955007898467600689403773245,
+        0.000000000000000000000000000000000
+    };
+    static const double wg[4] = {
+        0.129484966168869693270611432679082,
+        0.279705391489276667901467771423780,
+        0.381830050505118944950369775488975,
+        0.417959183673469387755102040816327
+    };
+    static const double wgk[8] = {
+        0.022935322010529224963732008058970,
+        0.063092092629978553290700663189204,
+        0.104790010322250183839876322541518,
+        0.140653259715525918745189590510238,
+        0.169004726639267902826583426598550,
+        0.190350578064785409913256402421014,
+        0.204432940075298892414161999234649,
+        0.209482141084727828012999174891714
+    };
+    const int n = 8;
+    double fv1[n], fv2[n];
+
+    const double center = 0.5 * (a + b);
+    const double half_length = 0.5 * (b - a);
+    const double abs_half_length = std::fabs(half_length);
+    const double f_center = f(center);
+
+    double result_gauss = f_center * wg[n / 2 - 1];
+    double result_kronrod = f_center * wgk[n - 1];
+    double result_abs = std::fabs(result_kronrod);
+
+    for (int j = 0; j < (n - 1) / 2; j++) {
+        const int jtw = j * 2 + 1;
+        const double abscissa = half_length * xgk[jtw];
+        const double fval1 = f(center - abscissa);
+        const double fval2 = f(center + abscissa);
+        const double fsum = fval1 + fval2;
+        fv1[jtw] = fval1;
+        fv2[jtw] = fval2;
+        result_gauss += wg[j] * fsum;
+        result_kronrod += wgk[jtw] * fsum;
+        result_abs += wgk[jtw] * (std::fabs(fval1) + std::fabs(fval2));
+    }
+    for (int j = 0; j < n / 2; j++) {
+        const int jtwm1 = j * 2;
+        const double abscissa = half_length * xgk[jtwm1];
+        const double fval1 = f(center - abscissa);
+        const double fval2 = f(center + abscissa);
+        fv1[jtwm1] = fval1;
+        fv2[jtwm1] = fval2;
+        result_kronrod += wgk[jtwm1] * (fval1 + fval2);
+        result_abs += wgk[jtwm1] * (std::fabs(fval1) + std::fabs(fval2));
+    }
+
+    const double mean = result_kronrod * 0.5;
+    double result_asc = wgk[n - 1] * std::fabs(f_center - mean);
+    for (int j = 0; j < n - 1; j++) {
+        result_asc += wgk[j] * (std::fabs(fv1[j] - mean) + std::fabs(fv2[j] - mean));
+    }
+
+    double err = (result_kronrod - result_gauss) * half_length;
+    result_kronrod *= half_length;
+    result_abs *= abs_half_length;
+    result_asc *= abs_half_length;
+
+    // rescale_error
+    err = std::fabs(err);
+    if (result_asc != 0.0 && err != 0.0) {
+        const double scale = std::pow(200.0 * err / result_asc, 1.5);
+        err = scale < 1.0 ? result_asc * scale : result_asc;
+    }
+    if (result_abs > DBL_MIN / (50.0 * DBL_EPSILON)) {
+        const double min_err = 50.0 * DBL_EPSILON * result_abs;
+        if (min_err > err) err = min_err;
+    }
+
+    result = result_kronrod;
+    abserr = err;
+
+    // QAG's test on the first step (a round-off failure is left to QAG to report)
+    const double tolerance = std::fmax(epsabs, epsrel * std::fabs(result));
+    const volatile double round_off = 50.0 * DBL_EPSILON * result_abs;
+    if (abserr <= round_off && abserr > tolerance) return false;
+    return (abserr <= tolerance && abserr != result_asc) || abserr == 0.0;
+}
+
+/** Integrate f over [a, b] with gsl_integration_qag (15-point rule).
+ * 
+ * This is reentrant: each thread uses its own GSL workspace, allocated on
+ * first use and freed when the thread exits.
+ * 
+ * @param f Integrand, called as f(t, params)
+ * @param params Passed to f
+ * @throws TRACED_EXCEPTION on errors from GSL */
+void integrateQag(double (*f)(double, void*), const void* params,
+        double a, double b, double epsabs, double epsrel,
+        double& result, double& abserr);
+
+}
+}
+#endif
@@ -132,6 +132,13 @@ public:
      * become negligible. */
     void decayDrugs (double body_mass);
     
+    /** True if no drugs have been taken or prescribed. Then medicate() and
+     * decayDrugs() do nothing, getDrugFactor() returns 1 and no random
+     * numbers are used. */
+    inline bool isEmpty() const{
+        return m_drugs.empty() && medicateQueue.empty();
+    }
+    
     /** Make summaries of drug concentration data. */
     void summarize( const Host::Human& human ) const;
     
@@ -35,6 +35,7 @@
 #include "util/random.h"
 #include "util/ModelOptions.h"
 #include "util/StreamValidator.h"
+#include "util/vectors.h"
 #include <schema/scenario.h>
 
 #include <cmath>
@@ -83,22 +84,20 @@ void Population::update()
     // size is assumed to be the _actual and exact_ population size by other code.
     int cumPop = 0;
 
-    for (auto it = humans.begin(); it != humans.end();) {
-        bool isDead = it->isDead();
+    // Single pass, keeping humans in order (oldest first)
+    util::vectors::compact( humans, [&]( const Host::Human& human ){
+        bool isDead = human.isDead();
 
         // if (Actual number of people so far > target population size for this age)
         // "outmigrate" some to maintain population shape
         //NOTE: better to use age(sim::ts0())? Possibly, but the difference will not be very significant.
         // Also see targetPop = ... comment above
-        bool outmigrate = cumPop >= AgeStructure::targetCumPop(sim::inSteps(it->age(sim::ts1())), size);
+        bool outmigrate = cumPop >= AgeStructure::targetCumPop(sim::inSteps(human.age(sim::ts1())), size);
         
-        if( isDead || outmigrate ){
-            it = humans.erase (it);
-            continue;
-        }
+        if( isDead || outmigrate ) return true;
         ++cumPop;
-        ++it;
-    } // end of per-human updates
+        return false;
+    } ); // end of per-human updates
 
     // increase population size to targetPop
     recentBirths += (size - cumPop);
@@ -130,6 +129,47 @@ void Population::checkpoint(ostream& stream)
         human.checkpoint(stream);
 }
 
+/* Accumulators of outputs computed over all humans. The ctsAdd* functions
+ * are called for each human in a single pass over the population (see
+ * Continuous::update); the corresponding output then writes and resets the
+ * accumulator. */
+static int ctsPatent = 0;
+static double ctsSumh = 0.0, ctsSumY = 0.0;
+static vector<double> ctsYList;        // cumulative Y of each human
+static int ctsNAvail = 0;
+static double ctsSumAvail = 0.0;
+static int ctsNITN = 0, ctsNIRS = 0, ctsNGVI = 0;
+
+static void ctsAddPatentHost (Host::Human &human){
+    auto diag = WithinHost::diagnostics::monitoringDiagnostic();
+    if( human.withinHostModel->diagnosticResult(human.rng, diag) )
+        ++ctsPatent;
+}
+static void ctsAddImmunityh (Host::Human &human){
+    ctsSumh += human.withinHostModel->getCumulative_h();
+}
+static void ctsAddImmunityY (Host::Human &human){
+    ctsSumY += human.withinHostModel->getCumulative_Y();
+}
+static void ctsAddMedianImmunityY (Host::Human &human){
+    ctsYList.push_back( human.withinHostModel->getCumulative_Y() );
+}
+static void ctsAddAgeAvailEffect (Host::Human &human){
+    if( !human.perHostTransmission.outsideTransmission ){
+        ++ctsNAvail;
+        ctsSumAvail += human.perHostTransmission.relativeAvailabilityAge(sim::inYears(human.age(sim::now())));
+    }
+}
+static void ctsAddITN (Host::Human &human){
+    ctsNITN += human.perHostTransmission.hasActiveInterv( interventions::Component::ITN );
+}
+static void ctsAddIRS (Host::Human &human){
+    ctsNIRS += human.perHostTransmission.hasActiveInterv( interventions::Component::IRS );
+}
+static void ctsAddGVI (Host::Human &human){
+    ctsNGVI += human.perHostTransmission.hasActiveInterv( interventions::Component::GVI );
+}
+
 void registerContinousPopulationCallbacks()
 {
     ostringstream ctsDemogTitle;
@@ -139,14 +179,14 @@ void registerContinousPopulationCallbacks()
     mon::Continuous.registerCallback( "hosts", "\thosts", &ctsHosts );
     mon::Continuous.registerCallback( "host demography", ctsDemogTitle.str(), &ctsHostDemography);
     mon::Continuous.registerCallback( "recent births", "\trecent births", &ctsRecentBirths);
-    mon::Continuous.registerCallback( "patent hosts", "\tpatent hosts", &ctsPatentHosts);
-    mon::Continuous.registerCallback( "immunity h", "\timmunity h", &ctsImmunityh);
-    mon::Continuous.registerCallback( "immunity Y", "\timmunity Y", &ctsImmunityY);
-    mon::Continuous.registerCallback( "median immunity Y", "\tmedian immunity Y", &ctsMedianImmunityY);
-    mon::Continuous.registerCallback( "human age availability", "\thuman age availability", &ctsMeanAgeAvailEffect);
-    mon::Continuous.registerCallback( "ITN coverage", "\tITN coverage", &ctsITNCoverage);
-    mon::Continuous.registerCallback( "IRS coverage", "\tIRS coverage", &ctsIRSCoverage);
-    mon::Continuous.registerCallback( "GVI coverage", "\tGVI coverage", &ctsGVICoverage);
+    mon::Continuous.registerCallback( "patent hosts", "\tpatent hosts", &ctsAddPatentHost, &ctsPatentHosts);
+    mon::Continuous.registerCallback( "immunity h", "\timmunity h", &ctsAddImmunityh, &ctsImmunityh);
+    mon::Continuous.registerCallback( "immunity Y", "\timmunity Y", &ctsAddImmunityY, &ctsImmunityY);
+    mon::Continuous.registerCallback( "median immunity Y", "\tmedian immunity Y", &ctsAddMedianImmunityY, &ctsMedianImmunityY);
+    mon::Continuous.registerCallback( "human age availability", "\thuman age availability", &ctsAddAgeAvailEffect, &ctsMeanAgeAvailEffect);
+    mon::Continuous.registerCallback( "ITN coverage", "\tITN coverage", &ctsAddITN, &ctsITNCoverage);
+    mon::Continuous.registerCallback( "IRS coverage", "\tIRS coverage", &ctsAddIRS, &ctsIRSCoverage);
+    mon::Continuous.registerCallback( "GVI coverage", "\tGVI coverage", &ctsAddGVI, &ctsGVICoverage);
 }
 
 void ctsHosts (Population &population, ostream& stream){
@@ -172,88 +212,62 @@ void ctsRecentBirths (Population &population, ostream& stream){
 }
 
 void ctsPatentHosts (Population &population, ostream& stream){
-    int patent = 0;
-    for(Host::Human &human : population.humans) {
-        auto diag = WithinHost::diagnostics::monitoringDiagnostic();
-        if( human.withinHostModel->diagnosticResult(human.rng, diag) )
-            ++patent;
-    }
-    stream << '\t' << patent;
+    stream << '\t' << ctsPatent;
+    ctsPatent = 0;
 }
 
 void ctsImmunityh (Population &population, ostream& stream){
-    double x = 0.0;
-    for(const Host::Human &human : population.humans) {
-        x += human.withinHostModel->getCumulative_h();
-    }
-    x /= population.getSize();
+    double x = ctsSumh / population.getSize();
+    ctsSumh = 0.0;
     stream << '\t' << x;
 }
 
 void ctsImmunityY (Population &population, ostream& stream){
-    double x = 0.0;
-    for(const Host::Human &human : population.humans) {
-        x += human.withinHostModel->getCumulative_Y();
-    }
-    x /= population.getSize();
+    double x = ctsSumY / population.getSize();
+    ctsSumY = 0.0;
     stream << '\t' << x;
 }
 
 void ctsMedianImmunityY (Population &population, ostream& stream){
-    vector<double> list;
-    list.reserve( population.getSize() );
-    for(const Host::Human &human : population.humans) {
-        list.push_back( human.withinHostModel->getCumulative_Y() );
-    }
-    sort( list.begin(), list.end() );
+    vector<double>& list = ctsYList;
+    assert( list.size() == population.getSize() );
+    // Selection instead of sorting: afterwards list[i] is the value it would
+    // have if sorted, with all smaller values before it.
+    size_t i = population.getSize() / 2;
+    nth_element( list.begin(), list.begin() + i, list.end() );
     double x;
     if( mod_nn(population.getSize(), 2) == 0 ){
-        size_t i = population.getSize() / 2;
-        x = (list[i-1]+list[i])/2.0;
+        double lower = *max_element( list.begin(), list.begin() + i );
+        x = (lower+list[i])/2.0;
     }else{
-        x = list[population.getSize() / 2];
+        x = list[i];
     }
+    list.clear();
     stream << '\t' << x;
 }
 
 void ctsMeanAgeAvailEffect (Population &population, ostream& stream){
-    int nHumans = 0;
-    double avail = 0.0;
-    for(Host::Human &human : population.humans) {
-        if( !human.perHostTransmission.outsideTransmission ){
-            ++nHumans;
-            avail += human.perHostTransmission.relativeAvailabilityAge(sim::inYears(human.age(sim::now())));
-        }
-    }
-    stream << '\t' << avail/nHumans;
+    stream << '\t' << ctsSumAvail/ctsNAvail;
+    ctsNAvail = 0;
+    ctsSumAvail = 0.0;
 }
 
 void ctsITNCoverage (Population &population, ostream& stream){
-    int nActive = 0;
-    for(const Host::Human &human : population.humans) {
-        nActive += human.perHostTransmission.hasActiveInterv( interventions::Component::ITN );
-    }
-    double coverage = static_cast<double>(nActive) / population.getSize();
+    double coverage = static_cast<double>(ctsNITN) / population.getSize();
+    ctsNITN = 0;
     stream << '\t' << coverage;
 }
 
 void ctsIRSCoverage (Population &population, ostream& stream){
-    int nActive = 0;
-    for(const Host::Human &human : population.humans) {
-        nActive += human.perHostTransmission.hasActiveInterv( interventions::Component::IRS );
-    }
-    double coverage = static_cast<double>(nActive) / population.getSize();
+    double coverage = static_cast<double>(ctsNIRS) / population.getSize();
+    ctsNIRS = 0;
     stream << '\t' << coverage;
 }
 
 void ctsGVICoverage (Population &population, ostream& stream){
-    int nActive = 0;
-    for(const Host::Human &human : population.humans) {
-        nActive += human.perHostTransmission.hasActiveInterv( interventions::Component::GVI );
-    }
-    double coverage = static_cast<double>(nActive) / population.getSize();
+    double coverage = static_cast<double>(ctsNGVI) / population.getSize();
+    ctsNGVI = 0;
     stream << '\t' << coverage;
 }
 
 }
-
@@ -27,6 +27,8 @@
 #include "PopulationAgeStructure.h"
 #include "Host/Human.h"
 
+#include <algorithm>
+#include <utility>
 #include <vector>
 
 namespace OM {
@@ -53,6 +55,22 @@ public:
     /** Reset the number of recent births to 0 */
     inline void resetRecentBirths();
 
+    /** Return the range of humans in [first, last) with age at time now in
+     * [minAge, maxAge).
+     * 
+     * Humans are kept in order of date of birth, oldest first (new humans are
+     * appended and removal keeps order), so this range is contiguous and is
+     * found by binary search. Works with any iterator over objects with an
+     * age(SimTime) member. */
+    template<class It>
+    static std::pair<It, It> ageRange(It first, It last, SimTime now, SimTime minAge, SimTime maxAge) {
+        It begin = std::partition_point(first, last,
+            [now, maxAge](const typename std::iterator_traits<It>::value_type& h) { return h.age(now) >= maxAge; });
+        It end = std::partition_point(begin, last,
+            [now, minAge](const typename std::iterator_traits<It>::value_type& h) { return h.age(now) >= minAge; });
+        return std::make_pair(begin, end);
+    }
+
     /** Checkpoint (read) */
     void checkpoint(istream& stream);
 
@@ -55,32 +55,62 @@ inline int argmax(const std::vector<double> &vec)
     return imax;
 }
 
-inline double findAngle(const double EIRRotageAngle, const vector<double> & FSCoeffic, const std::vector<double> &sim)
+/// Number of rotation angles per turn tried by findAngle
+const size_t FIND_ANGLE_STEPS = 365;
+
+/** Rotation angles tried by findAngle: from -π in steps of
+ * 2π/FIND_ANGLE_STEPS while below π, accumulated by repeated addition as
+ * fitting has always done (so that fitted rotations are unchanged). Due to
+ * rounding this has FIND_ANGLE_STEPS + 1 angles, the last just below π (the
+ * same rotation as the first). */
+inline const std::vector<double>& findAngleSteps()
 {
-    std::vector<double> temp(sim.size(), 0.0);
+    static const std::vector<double> steps = [](){
+        std::vector<double> angles;
+        double delta = 2.0 * M_PI / FIND_ANGLE_STEPS;
+        for(double angle=-M_PI; angle<M_PI; angle+=delta)
+            angles.push_back(angle);
+        return angles;
+    }();
+    return steps;
+}
 
-    double delta = 2.0 * M_PI / 365.0;
+/** Distance between the series generated from FSCoeffic rotated by angle and
+ * sim, as minimised by findAngle. temp is scratch space of size sim.size(). */
+inline double angleDistance(double angle, const vector<double> & FSCoeffic, const std::vector<double> &sim, std::vector<double> &temp)
+{
+    vectors::expIDFT(temp, FSCoeffic, angle);
 
-    double min = std::numeric_limits<double>::infinity();
-    double minAngle = 0.0;
-    for(double angle=-M_PI; angle<M_PI; angle+=delta)
+    // Minimize l1-norm
+    double sum = 0.0;
+    for(int i=0; i<sim::oneYear(); i++)
     {
-        vectors::expIDFT(temp, FSCoeffic, EIRRotageAngle + angle);
+        double v = fabs(temp[i] - sim[i]);
+        sum += v*v;
+    }
 
-        // Minimize l1-norm
-        double sum = 0.0;
-        for(int i=0; i<sim::oneYear(); i++)
-        {
-            double v = fabs(temp[i] - sim[i]);
-            sum += v*v;
-        }
+    return sqrtf(sum);
+}
 
-        sum = sqrtf(sum);
+/** Find the rotation angle (added to EIRRotageAngle) for which the series
+ * generated from FSCoeffic best matches sim. Tries each of findAngleSteps()
+ * and returns the index of the best (the first, if several are equal); this
+ * is the reference implementation of findAngleIndex. */
+inline size_t findAngleIndexBruteForce(const double EIRRotageAngle, const vector<double> & FSCoeffic, const std::vector<double> &sim)
+{
+    std::vector<double> temp(sim.size(), 0.0);
+
+    const std::vector<double>& angles = findAngleSteps();
+    double min = std::numeric_limits<double>::infinity();
+    size_t minIndex = 0;
+    for(size_t k = 0; k < angles.size(); ++k)
+    {
+        double sum = angleDistance(EIRRotageAngle + angles[k], FSCoeffic, sim, temp);
         if(sum < min)
         {
             min = sum;
-            minAngle = angle;
-            // cout << angle << " " << min << " " << sum << endl;
+            minIndex = k;
+            // cout << angles[k] << " " << min << " " << sum << endl;
         }
 
         // Or minimize peaks offset
@@ -91,11 +121,68 @@ inline double findAngle(const double EIRRotageAngle, const vector<double> & FSCo
         // if(offset < min)
         // {
         //     min = offset;
-        //     minAngle = angle;
+        //     minIndex = k;
         // }
 
     }
-    return minAngle;
+    return minIndex;
+}
+
+/** As findAngleIndexBruteForce, but in O(n log n) when sim has one value per
+ * angle step (as it does, since sim covers one year in days).
+ * 
+ * Angle k is -π + k·δ (up to rounding), with δ the sampling interval of sim,
+ * so the series generated for angle k is that for angle -π shifted by k
+ * samples (k mod n for the final angle, close to π). The squared
+ * distance to sim is then Σ series² + Σ sim² - 2·corr[k] where the first two
+ * terms don't depend on k, so the best angle maximises the circular
+ * cross-correlation corr.
+ * 
+ * The brute-force search compares distances in single precision, taking the
+ * first of any tie; the few angles close to the optimum are therefore
+ * re-evaluated exactly as it does, so that the result is the same. */
+inline size_t findAngleIndex(const double EIRRotageAngle, const vector<double> & FSCoeffic, const std::vector<double> &sim)
+{
+    const size_t n = sim.size();
+    if (n != FIND_ANGLE_STEPS) return findAngleIndexBruteForce(EIRRotageAngle, FSCoeffic, sim);
+
+    std::vector<double> base(n, 0.0), corr;
+    vectors::expIDFT(base, FSCoeffic, EIRRotageAngle - M_PI);
+    vectors::circularCrossCorrelation(base, sim, corr);
+
+    double sumSq = 0.0;
+    for (size_t t = 0; t < n; ++t) sumSq += base[t] * base[t] + sim[t] * sim[t];
+    std::vector<double> dist2(n);
+    double minDist2 = std::numeric_limits<double>::infinity();
+    for (size_t k = 0; k < n; ++k)
+    {
+        dist2[k] = sumSq - 2.0 * corr[k];
+        minDist2 = std::min(minDist2, dist2[k]);
+    }
+    // Generous compared to single precision (of the distance) and to rounding
+    // in corr (relative to the size of the terms)
+    const double tolerance = 1e-6 * minDist2 + 1e-10 * sumSq;
+
+    const std::vector<double>& angles = findAngleSteps();
+    double min = std::numeric_limits<double>::infinity();
+    size_t minIndex = 0;
+    for (size_t k = 0; k < angles.size(); ++k)
+    {
+        if (dist2[k % n] > minDist2 + tolerance) continue;
+        double sum = angleDistance(EIRRotageAngle + angles[k], FSCoeffic, sim, base);
+        if (sum < min)
+        {
+            min = sum;
+            minIndex = k;
+        }
+    }
+    return minIndex;
+}
+
+/// Best rotation angle, as found by findAngleIndex
+inline double findAngle(const double EIRRotageAngle, const vector<double> & FSCoeffic, const std::vector<double> &sim)
+{
+    return findAngleSteps()[findAngleIndex(EIRRotageAngle, FSCoeffic, sim)];
 }
 
 class AnophelesModelFitter
@@ -60,6 +60,7 @@ PerHost::PerHost () :
 
 void PerHost::initialise (LocalRng& rng, double availabilityFactor) {
     relativeAvailabilityHet = availabilityFactor;
+    factorCacheTime = sim::never();
     anophEntoAvailabilityRaw.resize(PerHostAnophParams::numSpecies());
     anophEntoAvailability.resize(PerHostAnophParams::numSpecies());
     anophProbMosqBiting.resize(PerHostAnophParams::numSpecies());
@@ -77,6 +78,7 @@ void PerHost::initialise (LocalRng& rng, double availabilityFactor) {
 }
 
 void PerHost::update(Host::Human& human){
+    factorCacheTime = sim::never();
     for( auto iter = activeComponents.begin(); iter != activeComponents.end(); ++iter ){
         (*iter)->update(human);
     }
@@ -85,6 +87,7 @@ void PerHost::update(Host::Human& human){
 void PerHost::deployComponent( LocalRng& rng, const HumanVectorInterventionComponent& params ){
     // This adds per-host per-intervention details to the host's data set.
     // This data is never removed since it can contain per-host heterogeneity samples.
+    factorCacheTime = sim::never();
     for( auto iter = activeComponents.begin(); iter != activeComponents.end(); ++iter ){
         if( (*iter)->id() == params.id() ){
             // already have a deployment for that description; just update it
@@ -101,34 +104,23 @@ void PerHost::deployComponent( LocalRng& rng, const HumanVectorInterventionCompo
 // (easily large enough for conceivable Weibull params that the value is 0.0 when
 // rounded to a double. Performance-wise it's perhaps slightly slower than using
 // an if() when interventions aren't present.
-double PerHost::entoAvailabilityHetVecItv (size_t species) const {
-    double alpha_i = anophEntoAvailability[species];
-    for( auto iter = activeComponents.begin(); iter != activeComponents.end(); ++iter ){
-        alpha_i *= (*iter)->relativeAttractiveness( species );
-    }
-    return alpha_i;
-}
-double PerHost::probMosqBiting (size_t species) const {
-    double P_B_i = anophProbMosqBiting[species];
-    for( auto iter = activeComponents.begin(); iter != activeComponents.end(); ++iter ){
-        P_B_i *= (*iter)->preprandialSurvivalFactor( species );
-    }
-    return P_B_i;
-}
-double PerHost::probMosqResting (size_t species) const {
-    double pRest = anophProbMosqResting[species];
-    for( auto iter = activeComponents.begin(); iter != activeComponents.end(); ++iter ){
-        pRest *= (*iter)->postprandialSurvivalFactor( species );
-    }
-    return pRest;
-}
-
-double PerHost::relMosqFecundity (size_t species) const {
-    double relFecundity = 1.0;
-    for( auto iter = activeComponents.begin(); iter != activeComponents.end(); ++iter ){
-        relFecundity *= (*iter)->relFecundity( species );
+void PerHost::updateFactorCache () const {
+    const size_t nSpecies = anophEntoAvailability.size();
+    factorCache.resize( nSpecies * NUM_FACTORS );
+    for( size_t species = 0; species < nSpecies; ++species ){
+        double *f = &factorCache[species * NUM_FACTORS];
+        f[ALPHA] = anophEntoAvailability[species];
+        f[P_B] = anophProbMosqBiting[species];
+        f[P_CD] = anophProbMosqResting[species];
+        f[FECUNDITY] = 1.0;
+        for( auto iter = activeComponents.begin(); iter != activeComponents.end(); ++iter ){
+            f[ALPHA] *= (*iter)->relativeAttractiveness( species );
+            f[P_B] *= (*iter)->preprandialSurvivalFactor( species );
+            f[P_CD] *= (*iter)->postprandialSurvivalFactor( species );
+            f[FECUNDITY] *= (*iter)->relFecundity( species );
+        }
     }
-    return relFecundity;
+    factorCacheTime = sim::nowOrTs1();
 }
 
 bool PerHost::hasActiveInterv(interventions::Component::Type type) const{
@@ -151,6 +143,7 @@ void PerHost::checkpointIntervs( istream& stream ){
     size_t l;
     l & stream;
     validateListSize(l);
+    factorCacheTime = sim::never();
     activeComponents.clear();
     for( size_t i = 0; i < l; ++i ){
         interventions::ComponentId id( stream );
@@ -297,19 +297,38 @@ public:
      * rate factors.)
      * 
      * Assume mean is human-to-vector availability rate factor. */
-    double entoAvailabilityHetVecItv (size_t species) const;
+    inline double entoAvailabilityHetVecItv (size_t species) const{
+        return factor( species, ALPHA );
+    }
     
     ///@brief Get effects of interventions pre/post biting
     //@{
     /** Probability of a mosquito succesfully biting a host (P_B_i). */
-    double probMosqBiting (size_t species) const;
+    inline double probMosqBiting (size_t species) const{
+        return factor( species, P_B );
+    }
     /** Probability of a mosquito succesfully finding a resting
      * place after biting and then resting (P_C_i * P_D_i). */
-    double probMosqResting (size_t species) const;
+    inline double probMosqResting (size_t species) const{
+        return factor( species, P_CD );
+    }
     /** Multiplicative factor for the number of fertile eggs laid by mosquitoes
      * after feeding on this host. Should be 1 normally, less than 1 to reduce
      * fertility, greater than 1 to increase. */
-    double relMosqFecundity (size_t species) const;
+    inline double relMosqFecundity (size_t species) const{
+        return factor( species, FECUNDITY );
+    }
+    
+    /** Get entoAvailabilityHetVecItv, probMosqBiting, probMosqResting and
+     * relMosqFecundity for one species. */
+    inline void vectorFactors (size_t species, double& alpha_i, double& P_B_i,
+                               double& pRest, double& relFecundity) const{
+        const double *f = &factors()[species * NUM_FACTORS];
+        alpha_i = f[ALPHA];
+        P_B_i = f[P_B];
+        pRest = f[P_CD];
+        relFecundity = f[FECUNDITY];
+    }
     //@}
     
     ///@brief Convenience wrappers around several functions
@@ -381,8 +400,32 @@ private:
     void checkpointIntervs( ostream& stream );
     void checkpointIntervs( istream& stream );
 
+    /// Index of each factor within a species' block of factorCache
+    enum Factor { ALPHA, P_B, P_CD, FECUNDITY, NUM_FACTORS };
+    
+    inline double factor (size_t species, Factor f) const{
+        return factors()[species * NUM_FACTORS + f];
+    }
+    /// Get factorCache, recalculating it if not valid for this time
+    inline const vector<double>& factors () const{
+        if( factorCacheTime != sim::nowOrTs1() ) updateFactorCache();
+        return factorCache;
+    }
+    void updateFactorCache () const;
+    
     vector<unique_ptr<PerHostInterventionData>> activeComponents;
     
+    /** Intervention-modified factors for all species (index
+     * species * NUM_FACTORS + factor), and the time at which they were
+     * calculated or sim::never() if component state changed since.
+     * 
+     * Component effects depend on the time and on their state, which changes
+     * only in update() and deployComponent(), so these are usually calculated
+     * once or twice per time step instead of on every access.
+     * Not checkpointed. */
+    mutable vector<double> factorCache;
+    mutable SimTime factorCacheTime = sim::never();
+    
     static AgeGroupInterpolator relAvailAge;
 };
 
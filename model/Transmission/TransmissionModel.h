@@ -40,6 +40,7 @@
 #include "util/CommandLine.h"
 #include "util/vectors.h"
 #include "util/ModelOptions.h"
+#include "util/parallel.h"
 
 #include <cmath>
 #include <cfloat>
@@ -138,6 +139,7 @@ protected:
         , surveySimulatedEIR(0.0)
         , adultAge(PerHost::adultAge())
         , numTransmittingHumans(0)
+        , adultInocs([this](const pair<double, double> &x) { addAdultInocs(x.first, x.second); })
     {
         // Set VACCINE_GENOTYPE option
         opt_vaccine_genotype = util::ModelOptions::option (util::VACCINE_GENOTYPE);
@@ -243,12 +245,7 @@ public:
 
         double allEIR = sum_EIR_i + sum_EIR_l;
         if (age >= adultAge)
-        {
-            tsAdultEntoInocs_i += sum_EIR_i;
-            tsAdultEntoInocs_l += sum_EIR_l;
-            tsAdultEntoInocs += allEIR;
-            tsNumAdults += 1;
-        }
+            adultInocs.record(make_pair(sum_EIR_i, sum_EIR_l));
         return allEIR;
     }
 
@@ -265,6 +262,7 @@ public:
         double sumWt_kappa = 0.0;
         double sumWeight = 0.0;
         numTransmittingHumans = 0;
+        vector<WithinHost::GenotypeTransmission> probTransGenotype;
 
         for (const Host::Human &human : population)
         {
@@ -273,9 +271,7 @@ public:
             const double avail = human.perHostTransmission.relativeAvailabilityHetAge(sim::inYears(human.age(sim::ts1())));
             sumWeight += avail;
 
-            vector<double> probTransGenotype_i(WithinHost::Genotypes::N());
-            vector<double> probTransGenotype_l(WithinHost::Genotypes::N());
-            const double pTransmit = human.withinHostModel->probTransmissionToMosquito(probTransGenotype_i, probTransGenotype_l);
+            const double pTransmit = human.withinHostModel->probTransmissionToMosquito(probTransGenotype);
 
             double riskTrans = 0.0;
 
@@ -285,8 +281,9 @@ public:
                 riskTrans = avail * pTransmit * human.vaccine.getFactor(interventions::Vaccine::TBV);
             else
             {
-                for (size_t g = 0; g < WithinHost::Genotypes::N(); ++g)
-                    riskTrans += (probTransGenotype_i[g] + probTransGenotype_l[g]) * human.vaccine.getFactor(interventions::Vaccine::TBV, g);
+                // genotypes not listed would only add zeros
+                for (const WithinHost::GenotypeTransmission &trans : probTransGenotype)
+                    riskTrans += (trans.prob_i + trans.prob_l) * human.vaccine.getFactor(interventions::Vaccine::TBV, trans.genotype);
                 riskTrans *= avail;
             }
 
@@ -488,6 +485,17 @@ private:
     double tsAdultEntoInocs = 0.0, tsAdultEntoInocs_i = 0.0, tsAdultEntoInocs_l = 0.0;
     int tsNumAdults = 0; // accumulator for time step adults requesting EIR
 
+    /// Adds to the above accumulators
+    inline void addAdultInocs(double sum_EIR_i, double sum_EIR_l)
+    {
+        tsAdultEntoInocs_i += sum_EIR_i;
+        tsAdultEntoInocs_l += sum_EIR_l;
+        tsAdultEntoInocs += sum_EIR_i + sum_EIR_l;
+        tsNumAdults += 1;
+    }
+    /// Inoculations of adults (i, l) reported while updating humans in parallel
+    util::parallel::Journal<pair<double, double>> adultInocs;
+
     bool opt_vaccine_genotype = false;
 };
 
@@ -94,40 +94,40 @@ void VectorModel::ctsCbS_v(ostream &stream)
     for (size_t i = 0; i < speciesIndex.size(); ++i)
         stream << '\t' << species[i]->getLastVecStat(Anopheles::SV);
 }
-void VectorModel::ctsCbAlpha(const vector<Host::Human> &population, ostream &stream)
+void VectorModel::ctsAddAlpha(Host::Human &human)
 {
+    const double ageYears = sim::inYears(human.age(sim::now()));
     for (size_t i = 0; i < speciesIndex.size(); ++i)
-    {
-        double total = 0.0;
-        for (const Host::Human &human : population)
-        {
-            total += human.perHostTransmission.entoAvailabilityFull(i, sim::inYears(human.age(sim::now())));
-        }
-        stream << '\t' << total / population.size();
-    }
+        ctsTotalAlpha[i] += human.perHostTransmission.entoAvailabilityFull(i, ageYears);
 }
-void VectorModel::ctsCbP_B(const vector<Host::Human> &population, ostream &stream)
+void VectorModel::ctsAddP_B(Host::Human &human)
 {
     for (size_t i = 0; i < speciesIndex.size(); ++i)
-    {
-        double total = 0.0;
-        for (const Host::Human &human : population)
-        {
-            total += human.perHostTransmission.probMosqBiting(i);
-        }
-        stream << '\t' << total / population.size();
-    }
+        ctsTotalP_B[i] += human.perHostTransmission.probMosqBiting(i);
 }
-void VectorModel::ctsCbP_CD(const vector<Host::Human> &population, ostream &stream)
+void VectorModel::ctsAddP_CD(Host::Human &human)
 {
     for (size_t i = 0; i < speciesIndex.size(); ++i)
+        ctsTotalP_CD[i] += human.perHostTransmission.probMosqResting(i);
+}
+void VectorModel::ctsCbAlpha(Population &population, ostream &stream)
+{
+    ctsWriteMeans(ctsTotalAlpha, population.humans.size(), stream);
+}
+void VectorModel::ctsCbP_B(Population &population, ostream &stream)
+{
+    ctsWriteMeans(ctsTotalP_B, population.humans.size(), stream);
+}
+void VectorModel::ctsCbP_CD(Population &population, ostream &stream)
+{
+    ctsWriteMeans(ctsTotalP_CD, population.humans.size(), stream);
+}
+void VectorModel::ctsWriteMeans(vector<double> &totals, size_t n, ostream &stream)
+{
+    for (size_t i = 0; i < totals.size(); ++i)
     {
-        double total = 0.0;
-        for (const Host::Human &human : population)
-        {
-            total += human.perHostTransmission.probMosqResting(i);
-        }
-        stream << '\t' << total / population.size();
+        stream << '\t' << totals[i] / n;
+        totals[i] = 0.0;
     }
 }
 void VectorModel::ctsNetInsecticideContent(const vector<Host::Human> &population, ostream &stream)
@@ -249,9 +249,16 @@ VectorModel::VectorModel(vector<double> initEIR, int interventionMode, vector<st
     Continuous.registerCallback("S_v", ctsSv.str(), std::bind( &VectorModel::ctsCbS_v, this, _1));
 
     // availability to mosquitoes relative to other humans, excluding age factor
-    Continuous.registerCallback("alpha", ctsAlpha.str(), std::bind( &VectorModel::ctsCbAlpha, this, _1, _2));
-    Continuous.registerCallback("P_B", ctsPB.str(), std::bind( &VectorModel::ctsCbP_B, this, _1, _2));
-    Continuous.registerCallback("P_C*P_D", ctsPCD.str(), std::bind( &VectorModel::ctsCbP_CD, this, _1, _2));
+    // these are accumulated in one pass over humans (per species)
+    ctsTotalAlpha.assign(numSpecies, 0.0);
+    ctsTotalP_B.assign(numSpecies, 0.0);
+    ctsTotalP_CD.assign(numSpecies, 0.0);
+    Continuous.registerCallback("alpha", ctsAlpha.str(), std::bind( &VectorModel::ctsAddAlpha, this, _1),
+        std::bind( &VectorModel::ctsCbAlpha, this, _1, _2));
+    Continuous.registerCallback("P_B", ctsPB.str(), std::bind( &VectorModel::ctsAddP_B, this, _1),
+        std::bind( &VectorModel::ctsCbP_B, this, _1, _2));
+    Continuous.registerCallback("P_C*P_D", ctsPCD.str(), std::bind( &VectorModel::ctsAddP_CD, this, _1),
+        std::bind( &VectorModel::ctsCbP_CD, this, _1, _2));
 
     Continuous.registerCallback("resource availability", ctsRA.str(), std::bind( &VectorModel::ctsCbResAvailability, this, _1));
     Continuous.registerCallback("resource requirements", ctsRR.str(), std::bind( &VectorModel::ctsCbResRequirements, this, _1));
@@ -451,46 +458,91 @@ void VectorModel::calculateEIR(Host::Human &human, double ageYears, vector<doubl
     }
 }
 
+void VectorModel::HostFactors::resize(size_t nHumans, size_t nSpecies, size_t nGenotypes)
+{
+    this->nHumans = nHumans;
+    this->nGenotypes = nGenotypes;
+    avail.resize(nSpecies * nHumans);
+    biting.resize(nSpecies * nHumans);
+    resting.resize(nSpecies * nHumans);
+    fecundity.resize(nSpecies * nHumans);
+    df.resize(nHumans);
+    infectious.clear();
+}
+
 // Every Global::interval days:
 void VectorModel::vectorUpdate(const vector<Host::Human> &population)
 {
     const size_t nGenotypes = WithinHost::Genotypes::N();
-    std::vector<double> probTransmission_i, probTransmission_l;
-    std::vector<double> sum_avail(speciesIndex.size());
-    std::vector<double> sigma_df(speciesIndex.size());
-    std::vector<double> sigma_dff(speciesIndex.size());
-    std::vector<std::vector<double>> sigma_dif_i(speciesIndex.size(), std::vector<double>(nGenotypes)), sigma_dif_l(speciesIndex.size(), std::vector<double>(nGenotypes));
-    for (const Host::Human &human : population)
+    const size_t nSpecies = speciesIndex.size();
+    HostFactors &hf = hostFactors;
+    hf.resize(population.size(), nSpecies, nGenotypes);
+
+    // Gather: one pass over humans (and their intervention components)
+    std::vector<WithinHost::GenotypeTransmission> probTransmission;
+    for (size_t h = 0; h < population.size(); ++h)
     {
+        const Host::Human &human = population[h];
         const OM::Transmission::PerHost &host = human.perHostTransmission;
         WithinHost::WHInterface &whm = *human.withinHostModel;
 
-        probTransmission_i.assign(nGenotypes, 0.0);
-        probTransmission_l.assign(nGenotypes, 0.0);
-        whm.probTransmissionToMosquito(probTransmission_i, probTransmission_l);
-
-        for (size_t s = 0; s < speciesIndex.size(); ++s)
+        whm.probTransmissionToMosquito(probTransmission);
+        bool infectious = false;
+        for (const WithinHost::GenotypeTransmission &trans : probTransmission)
+            infectious = infectious || trans.prob_i != 0.0 || trans.prob_l != 0.0;
+        if (infectious)
         {
-            // NOTE: calculate availability relative to age at end of time step;
-            // not my preference but consistent with TransmissionModel::getEIR().
-            // TODO: even stranger since probTransmission comes from the previous time step
-            const double avail = host.entoAvailabilityFull(s, sim::inYears(human.age(sim::ts1())));
-            sum_avail[s] += avail;
-            const double df = avail * host.probMosqBiting(s) * host.probMosqResting(s);
-            sigma_df[s] += df;
-            for (size_t g = 0; g < nGenotypes; ++g)
+            for (const WithinHost::GenotypeTransmission &trans : probTransmission)
             {
-                const double tbvFac = human.vaccine.getFactor(interventions::Vaccine::TBV, opt_vaccine_genotype? g : 0);
-                sigma_dif_i[s][g] += df * probTransmission_i[g] * tbvFac;
-                sigma_dif_l[s][g] += df * probTransmission_l[g] * tbvFac;
+                const double tbvFac = human.vaccine.getFactor(interventions::Vaccine::TBV, opt_vaccine_genotype? trans.genotype : 0);
+                hf.infectious.push_back(HostFactors::Infectious{h, trans.genotype, trans.prob_i, trans.prob_l, tbvFac});
             }
-            sigma_dff[s] += df * host.relMosqFecundity(s);
+        }
+
+        // NOTE: calculate availability relative to age at end of time step;
+        // not my preference but consistent with TransmissionModel::getEIR().
+        // TODO: even stranger since probTransmission comes from the previous time step
+        const double relAvailAge = host.relativeAvailabilityAge(sim::inYears(human.age(sim::ts1())));
+        for (size_t s = 0; s < nSpecies; ++s)
+        {
+            const size_t i = hf.row(s) + h;
+            double alpha_i;
+            host.vectorFactors(s, alpha_i, hf.biting[i], hf.resting[i], hf.fecundity[i]);
+            hf.avail[i] = alpha_i * relAvailAge;        // as entoAvailabilityFull
         }
     }
 
-    for (size_t s = 0; s < speciesIndex.size(); ++s)
+    // Reduce: per species, sums over humans in population order (hence
+    // results are identical to summing per human).
+    std::vector<double> sigma_dif_i(nGenotypes), sigma_dif_l(nGenotypes);
+    for (size_t s = 0; s < nSpecies; ++s)
     {
-        species[s]->advancePeriod(sum_avail[s], sigma_df[s], sigma_dif_i[s], sigma_dif_l[s], sigma_dff[s], simulationMode == dynamicEIR);
+        const double *avail = hf.avail.data() + hf.row(s);
+        const double *biting = hf.biting.data() + hf.row(s);
+        const double *resting = hf.resting.data() + hf.row(s);
+        const double *fecundity = hf.fecundity.data() + hf.row(s);
+        double *df = hf.df.data();
+
+        double sum_avail = 0.0, sigma_df = 0.0, sigma_dff = 0.0;
+        for (size_t h = 0; h < hf.nHumans; ++h)
+        {
+            df[h] = avail[h] * biting[h] * resting[h];
+            sum_avail += avail[h];
+            sigma_df += df[h];
+            sigma_dff += df[h] * fecundity[h];
+        }
+
+        // Non-infectious humans and genotypes not listed would only add
+        // zeros. Per genotype, terms are added in order of human.
+        sigma_dif_i.assign(nGenotypes, 0.0);
+        sigma_dif_l.assign(nGenotypes, 0.0);
+        for (const HostFactors::Infectious &inf : hf.infectious)
+        {
+            sigma_dif_i[inf.genotype] += df[inf.human] * inf.probTransmission_i * inf.tbvFac;
+            sigma_dif_l[inf.genotype] += df[inf.human] * inf.probTransmission_l * inf.tbvFac;
+        }
+
+        species[s]->advancePeriod(sum_avail, sigma_df, sigma_dif_i, sigma_dif_l, sigma_dff, simulationMode == dynamicEIR);
     }
 }
 
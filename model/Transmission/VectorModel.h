@@ -96,15 +96,56 @@ private:
     void ctsCbN_v(ostream &stream);
     void ctsCbO_v(ostream &stream);
     void ctsCbS_v(ostream &stream);
-    void ctsCbAlpha(const vector<Host::Human> &population, ostream &stream);
-    void ctsCbP_B(const vector<Host::Human> &population, ostream &stream);
-    void ctsCbP_CD(const vector<Host::Human> &population, ostream &stream);
+    void ctsAddAlpha(Host::Human &human);
+    void ctsAddP_B(Host::Human &human);
+    void ctsAddP_CD(Host::Human &human);
+    void ctsCbAlpha(Population &population, ostream &stream);
+    void ctsCbP_B(Population &population, ostream &stream);
+    void ctsCbP_CD(Population &population, ostream &stream);
+    // Write totals / n and reset totals
+    void ctsWriteMeans(vector<double> &totals, size_t n, ostream &stream);
     void ctsNetInsecticideContent(const vector<Host::Human> &population, ostream &stream);
     void ctsIRSInsecticideContent(const vector<Host::Human> &population, ostream &stream);
     void ctsIRSEffects(const vector<Host::Human> &population, ostream &stream);
     void ctsCbResAvailability(ostream &stream);
     void ctsCbResRequirements(ostream &stream);
 
+    /// Per-species sums over humans for continuous output (reset when written)
+    vector<double> ctsTotalAlpha, ctsTotalP_B, ctsTotalP_CD;
+
+    /** Per-human factors used by vectorUpdate, stored as one contiguous array
+     * per species and factor (struct of arrays) so that the sums over the
+     * population are simple loops.
+     *
+     * Refreshed at the start of each vectorUpdate; not checkpointed. */
+    struct HostFactors
+    {
+        /// Resize for nHumans humans, nSpecies species and nGenotypes genotypes
+        void resize(size_t nHumans, size_t nSpecies, size_t nGenotypes);
+
+        /// Start of species s's row in the per-species arrays
+        inline size_t row(size_t s) const { return s * nHumans; }
+
+        size_t nHumans = 0, nGenotypes = 0;
+        /// Per species and human: availability (α_i), P_B_i, P_C_i*P_D_i and
+        /// relative fecundity. Index: row(s) + human.
+        vector<double> avail, biting, resting, fecundity;
+        /// Per human: avail * biting * resting for the current species
+        vector<double> df;
+        /// Transmission of one genotype from one human
+        struct Infectious {
+            size_t human;
+            uint32_t genotype;
+            double probTransmission_i, probTransmission_l, tbvFac;
+        };
+        /** Genotypes which humans may transmit to mosquitoes, in order of
+         * human then genotype. Only humans with some non-zero
+         * probTransmission are listed; other humans and genotypes contribute
+         * nothing to sigma_dif. */
+        vector<Infectious> infectious;
+    };
+    HostFactors hostFactors;
+
 public:
     /// RNG used by the transmission model
     LocalRng m_rng;
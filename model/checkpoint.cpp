@@ -22,7 +22,6 @@
 
 #include <iostream>
 #include <fstream>
-#include <gzstream/gzstream.h>
 
 #include "Global.h"
 #include "mon/Continuous.h"
@@ -30,9 +29,19 @@
 #include "interventions/InterventionManager.h"
 #include "Host/NeonatalMortality.h"
 #include "Clinical/ClinicalModel.h"
+#include "util/DocumentLoader.h"
+#include "util/gzblocks.h"
 
 #include "checkpoint.h"
 
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <thread>
+
 namespace OM
 {
 
@@ -131,7 +140,18 @@ void checkpoint (ostream& stream, SimTime &endTime, SimTime &estEndTime, Populat
         throw util::checkpoint_error ("stream write error");
 }
 
-void writeCheckpoint(const bool startedFromCheckpoint, const string &checkpointFileName, SimTime &endTime, SimTime &estEndTime, Population &population, Transmission::TransmissionModel &transmission)
+/* Serialise the whole state to memory. Compression is done separately (by
+ * util::gzblocks), in parallel. */
+static string serialise(SimTime &endTime, SimTime &estEndTime, Population &population, Transmission::TransmissionModel &transmission)
+{
+    ostringstream stream(ios::out | ios::binary);
+    checkpoint (stream, endTime, estEndTime, population, transmission);
+    return stream.str();
+}
+
+/* Write data (compressed) to the next checkpoint file, then indicate it as
+ * the latest. */
+void rotateCheckpoint(const bool startedFromCheckpoint, const string &checkpointFileName, const string &data)
 {
     // We alternate between two checkpoints, in case program is closed while writing.
     const int NUM_CHECKPOINTS = 2;
@@ -143,12 +163,10 @@ void writeCheckpoint(const bool startedFromCheckpoint, const string &checkpointF
         checkpointNum = mod_nn(oldCheckpointNum + 1, NUM_CHECKPOINTS); // Get next checkpoint number:
     }
     
-    {   // Open the next checkpoint file for writing:
+    {   // Write the next checkpoint file:
         ostringstream name;
         name << checkpointFileName << checkpointNum << ".gz";
-        ogzstream out(name.str().c_str(), ios::out | ios::binary);
-        checkpoint (out, endTime, estEndTime, population, transmission);
-        out.close();
+        util::gzblocks::writeFile(name.str(), data);
     }
     
     {   // Indicate which is the latest checkpoint file.
@@ -169,6 +187,50 @@ void writeCheckpoint(const bool startedFromCheckpoint, const string &checkpointF
     }
 }
 
+void writeCheckpoint(const bool startedFromCheckpoint, const string &checkpointFileName, SimTime &endTime, SimTime &estEndTime, Population &population, Transmission::TransmissionModel &transmission)
+{
+    rotateCheckpoint(startedFromCheckpoint, checkpointFileName,
+            serialise(endTime, estEndTime, population, transmission));
+}
+
+/* Background writing of checkpoints: at most one at a time. Errors are
+ * reported by the next call to waitForCheckpoint. */
+struct CheckpointWriter {
+    thread worker;
+    exception_ptr error;
+    
+    ~CheckpointWriter(){
+        if (worker.joinable()) worker.join();
+    }
+} checkpointWriter;
+
+void writeCheckpointAsync(const string &checkpointFileName, SimTime &endTime, SimTime &estEndTime, Population &population, Transmission::TransmissionModel &transmission)
+{
+    waitForCheckpoint();
+    
+    // The state is serialised here; compression and writing happen later
+    auto data = make_shared<string>(serialise(endTime, estEndTime, population, transmission));
+    
+    checkpointWriter.worker = thread([checkpointFileName, data](){
+        try{
+            rotateCheckpoint(true, checkpointFileName, *data);
+        }catch (...){
+            checkpointWriter.error = current_exception();
+        }
+    });
+}
+
+void waitForCheckpoint()
+{
+    if (checkpointWriter.worker.joinable())
+        checkpointWriter.worker.join();
+    if (checkpointWriter.error){
+        exception_ptr error = checkpointWriter.error;
+        checkpointWriter.error = nullptr;
+        rethrow_exception(error);
+    }
+}
+
 void readCheckpoint(const string &checkpointFileName, SimTime &endTime, SimTime &estEndTime, Population &population, Transmission::TransmissionModel &transmission)
 {
     int checkpointNum = readCheckpointNum(checkpointFileName);
@@ -176,14 +238,58 @@ void readCheckpoint(const string &checkpointFileName, SimTime &endTime, SimTime
     // Open the latest file
     ostringstream name;
     name << checkpointFileName << checkpointNum << ".gz";
-    igzstream in(name.str().c_str(), ios::in | ios::binary);
-    //Note: gzstreams are considered "good" when file not open!
-    if ( !( in.good() && in.rdbuf()->is_open() ) )
-        throw util::checkpoint_error ("Unable to read file");
+    istringstream in(util::gzblocks::readFile(name.str()), ios::in | ios::binary);
     checkpoint (in, endTime, estEndTime, population, transmission);
-    in.close();
   
     cerr << sim::inSteps(sim::now()) << "t loaded checkpoint" << endl;
 }
 
-}
\ No newline at end of file
+string warmupCacheFile(const string &cacheDir, const string &scenarioFile)
+{
+    // Command-line options and resource path are included since they are
+    // checked when loading checkpoints
+    string options;
+    for( size_t i = 0; i < util::CommandLine::NUM_OPTIONS; ++i )
+        options.push_back( util::CommandLine::option(i) ? '1' : '0' );
+    ostringstream name;
+    name << cacheDir << "/warmup-" << util::hashScenarioWarmup(scenarioFile) << '-' << options
+        << '-' << std::hex << std::hash<string>()( util::CommandLine::lookupResource("") ) << ".gz";
+    return name.str();
+}
+
+bool readWarmupCache(const string &cacheFile, SimTime &endTime, SimTime &estEndTime, Population &population, Transmission::TransmissionModel &transmission)
+{
+    {
+        ifstream test(cacheFile, ios::in | ios::binary);
+        if( !test.is_open() ){
+            errno = 0; // Cleanup errno if file doesn't exist
+            return false;
+        }
+    }
+    istringstream in(util::gzblocks::readFile(cacheFile), ios::in | ios::binary);
+    checkpoint (in, endTime, estEndTime, population, transmission);
+
+    if (util::CommandLine::option(util::CommandLine::VERBOSE))
+        cout << "Loaded warmup from " << cacheFile << endl;
+    return true;
+}
+
+void writeWarmupCache(const string &cacheFile, SimTime &endTime, SimTime &estEndTime, Population &population, Transmission::TransmissionModel &transmission)
+{
+    // Several simulations may share the cache: write to a unique name, then rename
+    ostringstream tmpName;
+    tmpName << cacheFile << ".tmp"
+        << std::hex << std::chrono::steady_clock::now().time_since_epoch().count()
+        << '-' << std::hash<string>()( util::CommandLine::getOutputName() );
+    util::gzblocks::writeFile(tmpName.str(), serialise(endTime, estEndTime, population, transmission));
+    if( std::rename( tmpName.str().c_str(), cacheFile.c_str() ) != 0 ){
+        std::remove( tmpName.str().c_str() );
+        // Fine if another simulation wrote the file first (rename may not replace on Windows)
+        ifstream test(cacheFile, ios::in | ios::binary);
+        if( !test.is_open() )
+            throw util::checkpoint_error ("unable to create warmup cache file " + cacheFile);
+        errno = 0;
+    }
+}
+
+}
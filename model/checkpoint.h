@@ -36,6 +36,30 @@ namespace OM
     void writeCheckpoint(const bool startedFromCheckpoint, const string &checkpointFileName, SimTime &endTime, SimTime &estEndTime, Population &population, Transmission::TransmissionModel &transmission);
 
     void readCheckpoint(const string &checkpointFileName, SimTime &endTime, SimTime &estEndTime, Population &population, Transmission::TransmissionModel &transmission);
+
+    /** @brief periodic checkpoints
+    *
+    * writeCheckpointAsync writes a checkpoint like writeCheckpoint (after an
+    * earlier checkpoint), but only serialises the state to memory before
+    * returning; compression and writing happen on a background thread.
+    * waitForCheckpoint waits for this to finish and rethrows any error. */
+    void writeCheckpointAsync(const string &checkpointFileName, SimTime &endTime, SimTime &estEndTime, Population &population, Transmission::TransmissionModel &transmission);
+    void waitForCheckpoint();
+
+    /** @brief warmup cache
+    *
+    * The state at the start of the intervention period may be saved in a
+    * cache directory, in a file named by a hash of the scenario (see
+    * util::hashScenarioWarmup), and reloaded by later runs of scenarios
+    * differing only in intervention deployments.
+    *
+    * warmupCacheFile returns the path of the cache file for this scenario.
+    * readWarmupCache returns false if this file does not exist, otherwise
+    * loads it like a checkpoint. writeWarmupCache writes via a temporary file,
+    * so that concurrent runs never see a partial file. */
+    string warmupCacheFile(const string &cacheDir, const string &scenarioFile);
+    bool readWarmupCache(const string &cacheFile, SimTime &endTime, SimTime &estEndTime, Population &population, Transmission::TransmissionModel &transmission);
+    void writeWarmupCache(const string &cacheFile, SimTime &endTime, SimTime &estEndTime, Population &population, Transmission::TransmissionModel &transmission);
 }
 
 #endif
\ No newline at end of file
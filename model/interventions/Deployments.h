@@ -243,76 +243,76 @@ public:
     }
     
     virtual void deploy (vector<Host::Human> &population, Transmission::TransmissionModel& transmission) {
-        for(Human& human : population) {
-            const SimTime age = human.age(sim::now());
-            if( age >= minAge && age < maxAge ){
-                double availability = 0.0;
-                for(size_t i = 0; i < Transmission::PerHostAnophParams::numSpecies(); ++i)
-                    availability += human.perHostTransmission.anophEntoAvailability[i];
+        // Only humans within the age range (a contiguous slice) are visited
+        auto range = Population::ageRange(population.begin(), population.end(), sim::now(), minAge, maxAge);
+        for(auto it = range.first; it != range.second; ++it) {
+            Human& human = *it;
+            double availability = 0.0;
+            for(size_t i = 0; i < Transmission::PerHostAnophParams::numSpecies(); ++i)
+                availability += human.perHostTransmission.anophEntoAvailability[i];
 
-                double probability = coverage;
+            double probability = coverage;
 
-                if(copula && coverage > 0)
+            if(copula && coverage > 0)
+            {
+                try 
                 {
-                    try 
-                    {
-                        // Beta distribution for intervention (Beta distributed)
-                        const double beta_mean = coverage;  // Assuming this value is given
-                        const double beta_var = coverageVar;       // Given as well
-                        const double alpha = ((1.0 - beta_mean) / beta_var - 1.0 / beta_mean) * (beta_mean * beta_mean);
-                        const double beta = alpha * (1.0 / beta_mean - 1.0);
+                    // Beta distribution for intervention (Beta distributed)
+                    const double beta_mean = coverage;  // Assuming this value is given
+                    const double beta_var = coverageVar;       // Given as well
+                    const double alpha = ((1.0 - beta_mean) / beta_var - 1.0 / beta_mean) * (beta_mean * beta_mean);
+                    const double beta = alpha * (1.0 / beta_mean - 1.0);
 
-                        if(Transmission::PerHostAnophParams::numSpecies() > 1)
-                            throw std::runtime_error("only supports one mosquito species");
+                    if(Transmission::PerHostAnophParams::numSpecies() > 1)
+                        throw std::runtime_error("only supports one mosquito species");
 
-                        const double ux = Transmission::PerHostAnophParams::get(0).entoAvailability->cdf(human.perHostTransmission.anophEntoAvailabilityRaw[0]);
-                        if(ux < 1)
+                    const double ux = Transmission::PerHostAnophParams::get(0).entoAvailability->cdf(human.perHostTransmission.anophEntoAvailabilityRaw[0]);
+                    if(ux < 1)
+                    {
+                        double xx = gsl_cdf_ugaussian_Pinv(ux);                      // Unit interval to Normal
+
+                        // Apply the Gaussian copula transformation for correlation
+                        const ComponentId cid = subPop;
+
+                        /** human.rng.gauss(0.0, 1.0) is calculated once per component and per human. Re-deployment of
+                         * the same component on the same human must use the same gaussian sample. Therefore we store
+                         * this value in the human the first time it is calculated. */
+                        double g = 0.0;
+                        const auto it = human.perHostTransmission.copulaGaussianSamples.find(cid);
+                        if (it != human.perHostTransmission.copulaGaussianSamples.end())
+                            g = it->second;
+                        else
                         {
-                            double xx = gsl_cdf_ugaussian_Pinv(ux);                      // Unit interval to Normal
-
-                            // Apply the Gaussian copula transformation for correlation
-                            const ComponentId cid = subPop;
-
-                            /** human.rng.gauss(0.0, 1.0) is calculated once per component and per human. Re-deployment of
-                             * the same component on the same human must use the same gaussian sample. Therefore we store
-                             * this value in the human the first time it is calculated. */
-                            double g = 0.0;
-                            const auto it = human.perHostTransmission.copulaGaussianSamples.find(cid);
-                            if (it != human.perHostTransmission.copulaGaussianSamples.end())
-                                g = it->second;
-                            else
-                            {
-                                g = human.rng.gauss(0.0, 1.0);
-                                human.perHostTransmission.copulaGaussianSamples[cid] = g;
-                            }
-                            const double yy = coverageCorr * xx + g * sqrt(1 - coverageCorr * coverageCorr);
-
-                            // Transform back to unit interval
-                            const double uy = gsl_cdf_ugaussian_P(yy);
-
-                            if (alpha < 0 || beta < 0)
-                                throw std::runtime_error("resulting alpha and beta parameters must be positive");
-
-                            // Get the final probability from Beta distribution
-                            probability = gsl_cdf_beta_Pinv(uy, alpha, beta);
+                            g = human.rng.gauss(0.0, 1.0);
+                            human.perHostTransmission.copulaGaussianSamples[cid] = g;
                         }
-                        else // Gamma with CV=0
-                            probability = human.rng.beta(alpha, beta);
-                    }
-                    catch (const std::exception& e) {
-                        std::ostringstream oss;
-                        oss << "[Gaussian copula]: computing correlated intervention probability using Gaussian copula and Beta distribution: "
-                            << e.what()
-                            << ". Possible reason: coverage might be too high and/or population size might be too small.";
-                        throw std::runtime_error(oss.str());
+                        const double yy = coverageCorr * xx + g * sqrt(1 - coverageCorr * coverageCorr);
+
+                        // Transform back to unit interval
+                        const double uy = gsl_cdf_ugaussian_P(yy);
+
+                        if (alpha < 0 || beta < 0)
+                            throw std::runtime_error("resulting alpha and beta parameters must be positive");
+
+                        // Get the final probability from Beta distribution
+                        probability = gsl_cdf_beta_Pinv(uy, alpha, beta);
                     }
+                    else // Gamma with CV=0
+                        probability = human.rng.beta(alpha, beta);
                 }
+                catch (const std::exception& e) {
+                    std::ostringstream oss;
+                    oss << "[Gaussian copula]: computing correlated intervention probability using Gaussian copula and Beta distribution: "
+                        << e.what()
+                        << ". Possible reason: coverage might be too high and/or population size might be too small.";
+                    throw std::runtime_error(oss.str());
+                }
+            }
 
-                if( availability >= Transmission::PerHostAnophParams::getEntoAvailabilityPercentile(minAvailability) && availability <= Transmission::PerHostAnophParams::getEntoAvailabilityPercentile(maxAvailability) ) {
-                    if( subPop == ComponentId::wholePop() || (human.isInSubPop( subPop ) != complement) ){
-                        if( human.rng.bernoulli( probability ) ){
-                            deployToHuman( human, mon::Deploy::TIMED );
-                        }
+            if( availability >= Transmission::PerHostAnophParams::getEntoAvailabilityPercentile(minAvailability) && availability <= Transmission::PerHostAnophParams::getEntoAvailabilityPercentile(maxAvailability) ) {
+                if( subPop == ComponentId::wholePop() || (human.isInSubPop( subPop ) != complement) ){
+                    if( human.rng.bernoulli( probability ) ){
+                        deployToHuman( human, mon::Deploy::TIMED );
                     }
                 }
             }
@@ -359,18 +359,17 @@ public:
         // Cumulative case: bring target group's coverage up to target coverage
         vector<Host::Human*> unprotected;
         size_t total = 0;       // number of humans within age bound and optionally subPop
-        for(Host::Human &human : population) {
-            SimTime age = human.age(sim::now());
-            if( age >= minAge && age < maxAge ){
-                double availability = 0.0;
-                for(size_t i = 0; i < Transmission::PerHostAnophParams::numSpecies(); ++i)
-                    availability += human.perHostTransmission.anophEntoAvailability[i];
-                if( availability >= Transmission::PerHostAnophParams::getEntoAvailabilityPercentile(minAvailability) && availability <= Transmission::PerHostAnophParams::getEntoAvailabilityPercentile(maxAvailability) ) {
-                    if( subPop == ComponentId::wholePop() || (human.isInSubPop( subPop ) != complement) ){
-                        total+=1;
-                        if( !human.isInSubPop(cumCovInd) )
-                            unprotected.push_back( &human );
-                    }
+        auto range = Population::ageRange(population.begin(), population.end(), sim::now(), minAge, maxAge);
+        for(auto it = range.first; it != range.second; ++it) {
+            Host::Human &human = *it;
+            double availability = 0.0;
+            for(size_t i = 0; i < Transmission::PerHostAnophParams::numSpecies(); ++i)
+                availability += human.perHostTransmission.anophEntoAvailability[i];
+            if( availability >= Transmission::PerHostAnophParams::getEntoAvailabilityPercentile(minAvailability) && availability <= Transmission::PerHostAnophParams::getEntoAvailabilityPercentile(maxAvailability) ) {
+                if( subPop == ComponentId::wholePop() || (human.isInSubPop( subPop ) != complement) ){
+                    total+=1;
+                    if( !human.isInSubPop(cumCovInd) )
+                        unprotected.push_back( &human );
                 }
             }
         }
@@ -648,35 +647,30 @@ public:
             throw util::xml_scenario_error("timed intervention must have 0 <= minAvailability <= maxAvailability <= 100");
     }
     
+    /// Age at which humans are targeted
+    inline SimTime getDeployAge() const{ return deployAge; }
+    
     /** Apply filters and potentially deploy.
      * 
-     * @returns false iff this deployment (and thus all later ones in the
-     *  ordered list) happens in the future. */
-    bool filterAndDeploy( Host::Human& human ) const{
-        SimTime age = human.age(sim::now());
-        if( deployAge > age ){
-            // stop processing continuous deployments for this
-            // human for now because remaining ones happen in the future
-            return false;
-        }else if( deployAge == age ){
-            double availability = 0.0;
-            for(size_t i = 0; i < Transmission::PerHostAnophParams::numSpecies(); ++i)
-                availability += human.perHostTransmission.anophEntoAvailabilityRaw[i];
-
-            if( availability >= Transmission::PerHostAnophParams::getEntoAvailabilityPercentile(minAvailability) && availability <= Transmission::PerHostAnophParams::getEntoAvailabilityPercentile(maxAvailability) )
+     * Should be called for humans whose age is the target age (see
+     * getDeployAge()); the caller selects these by date of birth. */
+    void filterAndDeploy( Host::Human& human ) const{
+        double availability = 0.0;
+        for(size_t i = 0; i < Transmission::PerHostAnophParams::numSpecies(); ++i)
+            availability += human.perHostTransmission.anophEntoAvailabilityRaw[i];
+
+        if( availability >= Transmission::PerHostAnophParams::getEntoAvailabilityPercentile(minAvailability) && availability <= Transmission::PerHostAnophParams::getEntoAvailabilityPercentile(maxAvailability) )
+        {
+            auto now = sim::intervDate();
+            if( begin <= now && now < end &&
+                ( subPop == ComponentId::wholePop() ||
+                    (human.isInSubPop( subPop ) != complement)
+                ) &&
+                human.rng.uniform_01() < coverage )     // RNG call should be last test
             {
-                auto now = sim::intervDate();
-                if( begin <= now && now < end &&
-                    ( subPop == ComponentId::wholePop() ||
-                        (human.isInSubPop( subPop ) != complement)
-                    ) &&
-                    human.rng.uniform_01() < coverage )     // RNG call should be last test
-                {
-                    deployToHuman( human, mon::Deploy::CTS );
-                }
+                deployToHuman( human, mon::Deploy::CTS );
             }
-        }//else: for some reason, a deployment age was missed; ignore it
-        return true;
+        }
     }
     
     inline void print_details( std::ostream& out )const{
@@ -555,21 +555,34 @@ void InterventionManager::deploy(vector<Host::Human> &population, Transmission::
     }
 
     // deploy continuous interventions
-    for (Host::Human &human : population)
+    // Only the birth cohort whose age equals a target age can be deployed to,
+    // so for each distinct target age this cohort is looked up by date of
+    // birth. The population is ordered oldest first and continuous is sorted
+    // by age, so going through the ages in decreasing order visits humans in
+    // the same order as a full scan would.
+    for (size_t last = continuous.size(); last > 0;)
     {
-        uint32_t nextCtsDist = human.nextCtsDist;
-        // deploy continuous interventions
-        while (nextCtsDist < continuous.size())
+        const SimTime deployAge = continuous[last - 1].getDeployAge();
+        size_t first = last - 1;
+        while (first > 0 && continuous[first - 1].getDeployAge() == deployAge) first -= 1;
+
+        auto cohort = Population::ageRange(population.begin(), population.end(),
+                sim::now(), deployAge, deployAge + sim::oneDay());
+        if (cohort.first != cohort.second && util::CommandLine::option(util::CommandLine::VERBOSE))
         {
-            if (util::CommandLine::option(util::CommandLine::VERBOSE))
+            for (size_t i = first; i < last; ++i)
             {
                 cout << "deploy::" << now << "::Continuous";
-                continuous[nextCtsDist].print_details(cout);
+                continuous[i].print_details(cout);
                 cout << endl;
             }
-            if (!continuous[nextCtsDist].filterAndDeploy(human)) break; // deployment (and all remaining) happens in the future
-            nextCtsDist = ++human.nextCtsDist;
         }
+        for (auto it = cohort.first; it != cohort.second; ++it)
+        {
+            for (size_t i = first; i < last; ++i)
+                continuous[i].filterAndDeploy(*it);
+        }
+        last = first;
     }
 }
 
@@ -29,6 +29,8 @@
 #include "util/StreamValidator.h"
 #include "util/DocumentLoader.h"
 #include "util/XMLChecker.h"
+#include "util/parallel.h"
+#include "util/UnitParse.h"
 
 #include "mon/Continuous.h"
 #include "mon/management.h"
@@ -42,6 +44,12 @@
 #include "schema/scenario.h"
 
 #include <cerrno>
+#include <map>
+#include <thread>
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 namespace OM {
     using mon::Continuous;
@@ -51,6 +59,11 @@ namespace OM {
 
 using namespace OM;
 
+// Checkpoint file name, and interval between checkpoints during the
+// intervention period (zero if not used; see --checkpoint-every)
+string checkpointFileName;
+SimTime checkpointEvery = sim::zero();
+
 void print_progress(int lastPercent, SimTime &estEndTime)
 {
     int percent = (sim::now() * 100) / estEndTime;
@@ -108,11 +121,13 @@ void run(Population &population, TransmissionModel &transmission, SimTime humanW
         // (until humans old enough to be pregnate get updated and can be infected).
         Host::NeonatalMortality::update (population.humans);
         
-        for (Host::Human& human : population.humans)
-        {
+        // Humans are independent here (each has its own RNG); shared outputs
+        // are merged in population order, so results don't depend on threading.
+        util::parallel::forEach( population.humans.size(), [&]( size_t i ){
+            Host::Human& human = population.humans[i];
             if (human.getDOB() + sim::maxHumanAge() >= humanWarmupLength) // this is last time of possible update
                 Host::update(human, transmission);
-        }
+        } );
        
         population.update();
         
@@ -123,6 +138,17 @@ void run(Population &population, TransmissionModel &transmission, SimTime humanW
 
         sim::end_update();
 
+        if (checkpointEvery > sim::zero() && sim::intervTime() > sim::zero() && sim::now() < endTime
+            && mod_nn(sim::intervTime(), checkpointEvery) == sim::zero())
+        {
+            writeCheckpointAsync(checkpointFileName, endTime, estEndTime, population, transmission);
+            if (util::CommandLine::option(util::CommandLine::CHECKPOINT_STOP))
+            {
+                waitForCheckpoint();
+                throw util::cmd_exception("Checkpoint test: checkpoint written", util::Error::None);
+            }
+        }
+
         if (util::CommandLine::option(util::CommandLine::PROGRESS))
             print_progress(lastPercent, estEndTime);
         print_errno();
@@ -131,6 +157,52 @@ void run(Population &population, TransmissionModel &transmission, SimTime humanW
     if (util::CommandLine::option(util::CommandLine::VERBOSE)) cout << "Finishing " << phase << "..." << endl;
 }
 
+#ifndef _WIN32
+/* With --ensemble: start one process per replicate, sharing (copy-on-write)
+ * everything initialised so far. Up to one replicate per core runs at once
+ * (fewer with --threads).
+ * 
+ * Returns the replicate number in each replicate process. In the original
+ * process, waits for all replicates, then returns n; exitStatus is set to
+ * the status of the first replicate to fail, if any. */
+size_t forkReplicates(size_t n, int &exitStatus)
+{
+    const size_t threads = util::CommandLine::getNumThreads();
+    const size_t maxRunning = threads == 0 ? 1 :
+        max<size_t>(1, max(1u, std::thread::hardware_concurrency()) / threads);
+    map<pid_t, size_t> running;
+    
+    // Buffered output would otherwise be written by every process
+    cout << flush;
+    cerr << flush;
+    fflush(nullptr);
+    
+    for (size_t k = 0; k < n || !running.empty(); ) {
+        if (k < n && running.size() < maxRunning) {
+            pid_t pid = fork();
+            if (pid < 0)
+                throw util::base_exception("--ensemble: unable to start process", util::Error::Default);
+            if (pid == 0)
+                return k;
+            running[pid] = k++;
+        } else {
+            int status = 0;
+            pid_t pid = wait(&status);
+            if (pid < 0)
+                throw util::base_exception("--ensemble: error waiting for process", util::Error::Default);
+            const int code = WIFEXITED(status) ? WEXITSTATUS(status) : EXIT_FAILURE;
+            if (code != EXIT_SUCCESS) {
+                cerr << "Replicate " << running[pid] << " failed (exit status " << code << ")" << endl;
+                if (exitStatus == EXIT_SUCCESS)
+                    exitStatus = code;
+            }
+            running.erase(pid);
+        }
+    }
+    return n;
+}
+#endif
+
 /// main() — loads scenario XML and runs simulation
 int main(int argc, char* argv[])
 {
@@ -138,7 +210,6 @@ int main(int argc, char* argv[])
     bool startedFromCheckpoint;
 
     string scenarioFile;
-    string checkpointFileName;
     SimTime estEndTime, endTime;
     
     try {
@@ -175,6 +246,25 @@ int main(int argc, char* argv[])
         Host::NeonatalMortality::init( scenario->getModel().getClinical() );
         AgeStructure::init( scenario->getDemography() );
 
+        // With --ensemble, each replicate continues from here in its own
+        // process, with seed iseed + replicate number. The RNG has not been
+        // used yet, so the first replicate is identical to a normal run.
+#ifndef _WIN32
+        const size_t ensembleSize = util::CommandLine::getEnsembleSize();
+        if (ensembleSize > 1)
+        {
+            const size_t replicate = forkReplicates(ensembleSize, exitStatus);
+            if (replicate == ensembleSize)
+                return exitStatus;
+            const int seed = scenario->getModel().getComputationParameters().getIseed() + replicate;
+            if (replicate > 0)
+                util::CommandLine::addOutputSuffix("_seed" + to_string(seed));
+            util::master_RNG.seed( seed, 0 );
+        }
+#endif
+        // Worker threads are started after forking
+        util::parallel::init( util::CommandLine::getNumThreads() );
+
         // 3) elements depending on other elements; dependencies on (1) are not mentioned:
         // Transmission model initialisation depends on Transmission::PerHost and
         // genotypes (both from Human, from Population::init()) and
@@ -212,6 +302,17 @@ int main(int argc, char* argv[])
         if(checkpointFileName == "")
             checkpointFileName = "checkpoint";
 
+        if(util::CommandLine::getCheckpointEvery() != "")
+        {
+            try {
+                checkpointEvery = UnitParse::readDuration(util::CommandLine::getCheckpointEvery(), UnitParse::NONE);
+            } catch (const util::format_error& e) {
+                throw util::cmd_exception(string("--checkpoint-every: ") + e.message());
+            }
+            if(checkpointEvery < sim::oneTS())
+                throw util::cmd_exception("--checkpoint-every: must be at least one time step");
+        }
+
         if(util::CommandLine::option(util::CommandLine::CHECKPOINT))
         {
             ifstream checkpointFile(checkpointFileName,ios::in);
@@ -221,6 +322,17 @@ int main(int argc, char* argv[])
         }
         else
             startedFromCheckpoint = false;
+
+        string warmupCache;
+        if (!startedFromCheckpoint && util::CommandLine::getWarmupCacheDir() != "")
+        {
+            // Output written during the warmup can't be reproduced from the cache
+            const scnXml::Monitoring::ContinuousOptional& ctsOpt = scenario->getMonitoring().getContinuous();
+            if (ctsOpt.present() && ctsOpt.get().getDuringInit().present() && ctsOpt.get().getDuringInit().get())
+                cerr << "Warning: warmup cache not used since continuous output is reported during initialisation" << endl;
+            else
+                warmupCache = warmupCacheFile(util::CommandLine::getWarmupCacheDir(), scenarioFile);
+        }
         
         estEndTime = humanWarmupLength + (sim::endDate() - sim::startDate()) + sim::oneTS();
         assert( estEndTime + sim::never() < sim::zero() );
@@ -236,47 +348,59 @@ int main(int argc, char* argv[])
         else
         {
             Continuous.init(scenario->getMonitoring(), false);
-            population->createInitialHumans();
-            transmission->init2(population->humans);
-            
-            /** Calculate ento availability percentiles **/
-            Transmission::PerHostAnophParams::calcAvailabilityPercentiles();
-
-            /** Warm-up phase: 
-             * Run the simulation using the equilibrium inoculation rates over one
-             * complete lifespan (sim::maxHumanAge()) to reach immunological
-             * equilibrium in all age classes. Don't report any events. */
-            endTime = humanWarmupLength;
-            run(*population, *transmission, humanWarmupLength, endTime, estEndTime, surveyOnlyNewEp, "Warmup");
-
-            /** Transmission init phase:
-             * Fit the emergence rate to the input EIR */
-            SimTime iterate = transmission->initIterate();
-            while(iterate > sim::zero())
+            if (warmupCache != "" && readWarmupCache(warmupCache, endTime, estEndTime, *population, *transmission))
             {
-                endTime = endTime + iterate;
-                // adjust estimation of final time step: end of current period + length of main phase
-                estEndTime = endTime + (sim::endDate() - sim::startDate()) + sim::oneTS();
-                run(*population, *transmission, humanWarmupLength, endTime, estEndTime, surveyOnlyNewEp, "EIR Calibration");
-                iterate = transmission->initIterate();
+                // The cached state is that at the start of the intervention period.
+                /** Calculate ento availability percentiles **/
+                Transmission::PerHostAnophParams::calcAvailabilityPercentiles();
+            }
+            else
+            {
+                population->createInitialHumans();
+                transmission->init2(population->humans);
+            
+                /** Calculate ento availability percentiles **/
+                Transmission::PerHostAnophParams::calcAvailabilityPercentiles();
+
+                /** Warm-up phase: 
+                 * Run the simulation using the equilibrium inoculation rates over one
+                 * complete lifespan (sim::maxHumanAge()) to reach immunological
+                 * equilibrium in all age classes. Don't report any events. */
+                endTime = humanWarmupLength;
+                run(*population, *transmission, humanWarmupLength, endTime, estEndTime, surveyOnlyNewEp, "Warmup");
+
+                /** Transmission init phase:
+                 * Fit the emergence rate to the input EIR */
+                SimTime iterate = transmission->initIterate();
+                while(iterate > sim::zero())
+                {
+                    endTime = endTime + iterate;
+                    // adjust estimation of final time step: end of current period + length of main phase
+                    estEndTime = endTime + (sim::endDate() - sim::startDate()) + sim::oneTS();
+                    run(*population, *transmission, humanWarmupLength, endTime, estEndTime, surveyOnlyNewEp, "EIR Calibration");
+                    iterate = transmission->initIterate();
+                }
+
+                /** Main phase:
+                 * This procedure starts with the current state of the simulation 
+                 * It continues updating assuming:
+                 * (i)         the default (exponential) demographic model
+                 * (ii)        the entomological input defined by the EIRs in intEIR()
+                 * (iii)       the intervention packages defined in Intervention()
+                 * (iv)        the survey times defined in Survey() */
+                // reset endTime and estEndTime to their exact value after initIterate()
+                estEndTime = endTime = endTime + (sim::endDate() - sim::startDate()) + sim::oneTS();
+                sim::s_interv = sim::zero();
+                Host::InfectionIncidenceModel::preMainSimInit();
+                Clinical::InfantMortality::preMainSimInit();
+                WithinHost::Genotypes::preMainSimInit();
+                population->resetRecentBirths();
+                transmission->summarize(); // Only to reset TransmissionModel::inoculationsPerAgeGroup
+                mon::initMainSim();
+
+                if (warmupCache != "")
+                    writeWarmupCache(warmupCache, endTime, estEndTime, *population, *transmission);
             }
-
-            /** Main phase:
-             * This procedure starts with the current state of the simulation 
-             * It continues updating assuming:
-             * (i)         the default (exponential) demographic model
-             * (ii)        the entomological input defined by the EIRs in intEIR()
-             * (iii)       the intervention packages defined in Intervention()
-             * (iv)        the survey times defined in Survey() */
-            // reset endTime and estEndTime to their exact value after initIterate()
-            estEndTime = endTime = endTime + (sim::endDate() - sim::startDate()) + sim::oneTS();
-            sim::s_interv = sim::zero();
-            Host::InfectionIncidenceModel::preMainSimInit();
-            Clinical::InfantMortality::preMainSimInit();
-            WithinHost::Genotypes::preMainSimInit();
-            population->resetRecentBirths();
-            transmission->summarize(); // Only to reset TransmissionModel::inoculationsPerAgeGroup
-            mon::initMainSim();
 
             if(util::CommandLine::option (util::CommandLine::CHECKPOINT))
             {
@@ -291,10 +415,13 @@ int main(int argc, char* argv[])
        
         cerr << '\r' << flush;  // clean last line of progress-output
         
+        waitForCheckpoint();
+
         for(Host::Human &human : population->humans)
             human.clinicalModel->flushReports();
 
         mon::writeSurveyData();
+        Continuous.finish();
         
     # ifdef OM_STREAM_VALIDATOR
         util::StreamValidator.saveStream();
@@ -29,7 +29,12 @@
 
 #include <vector>
 #include <map>
+#include <deque>
 #include <fstream>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <gzstream/gzstream.h>
 
 namespace OM {
@@ -49,10 +54,105 @@ namespace OM {
         streamoff streamOff;
         streampos streamStart;
 
-        map<string, tuple<string, std::function<void(Population&, ostream&)>> > registered;
+        /* Unless --ctsout-live is used, lines are collected in `buffer` and
+         * written in large blocks by a background thread, so that the
+         * simulation does not wait for the file system (this may be slow, e.g.
+         * over NFS). With --ctsout-live, each line is written and flushed
+         * immediately, for viewing output while the simulation runs. */
+        class BlockWriter {
+        public:
+            ~BlockWriter(){ stop(); }
+
+            // Queue a block for writing to ctsOStream
+            void write( string&& block ){
+                lock_guard<mutex> lock( m );
+                if( !worker.joinable() )
+                    worker = thread( &BlockWriter::run, this );
+                queue.push_back( std::move(block) );
+                wake.notify_one();
+            }
+            // Wait until all queued blocks have been written and flushed
+            void sync(){
+                unique_lock<mutex> lock( m );
+                idle.wait( lock, [this]{ return queue.empty() && !busy; } );
+            }
+            // Write all queued blocks, then stop the thread
+            void stop(){
+                {
+                    lock_guard<mutex> lock( m );
+                    stopping = true;
+                }
+                wake.notify_one();
+                if( worker.joinable() ) worker.join();
+                stopping = false;
+            }
+
+        private:
+            void run(){
+                unique_lock<mutex> lock( m );
+                while( true ){
+                    wake.wait( lock, [this]{ return !queue.empty() || stopping; } );
+                    if( queue.empty() ) return;     // stopping
+                    string block = std::move( queue.front() );
+                    queue.pop_front();
+                    busy = true;
+                    lock.unlock();
+                    ctsOStream.write( block.data(), block.size() );
+                    ctsOStream.flush();
+                    lock.lock();
+                    busy = false;
+                    if( queue.empty() ) idle.notify_all();
+                }
+            }
+
+            mutex m;
+            condition_variable wake, idle;
+            deque<string> queue;
+            bool busy = false, stopping = false;
+            thread worker;
+        };
+        BlockWriter writer;
+
+        /// Lines not yet passed to writer, and their position in the file
+        /// (minus start). Blocks are passed once they reach BLOCK_SIZE.
+        ostringstream buffer;
+        streamoff bufferOff;
+        const streamoff BLOCK_SIZE = 1 << 16;
+
+        bool live = false;
+
+        // Pass buffered lines to writer
+        void flushBuffer(){
+            const streamoff len = buffer.tellp();
+            if( len <= 0 ) return;
+            writer.write( buffer.str() );
+            buffer.str( "" );
+            bufferOff += len;
+        }
+        // Write everything, then check for errors
+        void sync(){
+            flushBuffer();
+            writer.sync();
+            if( ctsOStream.fail() )
+                throw util::base_exception( "unable to write " + cts_filename, util::Error::FileIO );
+        }
+
+        /* Registered outputs: titles, function writing the output and (for
+         * outputs computed over all humans) function adding a human. */
+        typedef tuple<string, std::function<void(Population&, ostream&)>,
+            std::function<void(Host::Human&)>> Output;
+        map<string, Output> registered;
 
         // List that we report.
-        vector< tuple<string, std::function<void(Population&, ostream&)>> > toReport;
+        vector<Output> toReport;
+        // Functions adding a human, of the outputs in toReport which have one.
+        // All are called in a single pass over the population.
+        vector<std::function<void(Host::Human&)>> toAdd;
+
+        void enable( const Output& output ){
+            toReport.push_back( output );
+            if( std::get<2>(output) ) toAdd.push_back( std::get<2>(output) );
+        }
 
         SimTime ctsPeriod = sim::zero();
 
@@ -60,7 +160,11 @@ namespace OM {
 
         ContinuousType Continuous;
 
-        ContinuousType::~ContinuousType() {}
+        ContinuousType::~ContinuousType() {
+            // write anything remaining (if finish() was not called)
+            flushBuffer();
+            writer.stop();
+        }
 
         /* Initialise: enable outputs registered and requested in XML.
          * Search for Continuous::registerCallback to see outputs available. */
@@ -83,6 +187,7 @@ namespace OM {
                 duringInit = ctsOpt.get().getDuringInit().get();
 
             cts_filename = util::CommandLine::getCtsoutName();
+            live = util::CommandLine::option( util::CommandLine::CTSOUT_LIVE );
 
             ctsOStream.width (0);
 
@@ -93,7 +198,7 @@ namespace OM {
                     if( reg_it == registered.end() )
                         throw xml_scenario_error("monitoring.continuous: no output " + string(it->getName()));
                     if( it->getValue() ){
-                        toReport.push_back( reg_it->second );
+                        enable( reg_it->second );
                     }
                 }
 
@@ -120,18 +225,29 @@ namespace OM {
                         throw xml_scenario_error("monitoring.continuous: no output " + string(it->getName()));
                     if( it->getValue() ){
                         ctsOStream << std::get<0>(reg_it->second);
-                        toReport.push_back( reg_it->second );
+                        enable( reg_it->second );
                     }
                 }
                 ctsOStream << mon::lineEnd << flush;
                 streamOff = ctsOStream.tellp() - streamStart;
+                bufferOff = streamOff;
             }
         }
 
+        void ContinuousType::finish (){
+            if( ctsPeriod == sim::zero() )
+                return;	// output disabled
+
+            sync();
+            writer.stop();
+        }
+
         void ContinuousType::checkpoint (ostream& stream){
             if( ctsPeriod == sim::zero() )
                 return;	// output disabled
 
+            // The file must contain everything up to streamOff
+            sync();
             streamOff & stream;
         }
         void ContinuousType::checkpoint (istream& stream){
@@ -146,6 +262,9 @@ namespace OM {
             streamOff & stream;
             // We skip back to the last write-point, so anything written after the
             // last checkpoint will be repeated:
+            writer.sync();
+            buffer.str( "" );
+            bufferOff = streamOff;
             ctsOStream.seekp( streamOff, ios_base::beg );
 
             if( ctsOStream.fail() )
@@ -155,23 +274,30 @@ namespace OM {
         void ContinuousType::registerCallback (string optName, string titles, function<void(ostream&)> f){
             assert(registered.count(optName) == 0); // name clash/registered twice?
             function<void(const Population&, ostream&)> _f = [f](const Population&, ostream& ostream){ f(ostream); };
-            registered[optName] = {titles, _f};
+            registered[optName] = Output{titles, _f, nullptr};
         }
 
         void ContinuousType::registerCallback (string optName, string titles, function<void(const vector<Host::Human> &, ostream&)> f){
             assert(registered.count(optName) == 0); // name clash/registered twice?
             function<void(const Population&, ostream&)> _f = [f](const Population &p, ostream& ostream){ f(p.humans, ostream); };
-            registered[optName] = {titles, _f};
+            registered[optName] = Output{titles, _f, nullptr};
         }
 
         void ContinuousType::registerCallback (string optName, string titles, function<void(Population &, ostream&)> f){
             assert(registered.count(optName) == 0); // name clash/registered twice?
-            registered[optName] = {titles, f};
+            registered[optName] = Output{titles, f, nullptr};
+        }
+
+        void ContinuousType::registerCallback (string optName, string titles,
+                function<void(Host::Human&)> add, function<void(Population &, ostream&)> f){
+            assert(registered.count(optName) == 0); // name clash/registered twice?
+            registered[optName] = Output{titles, f, add};
         }
 
         void ContinuousType::update (Population &population){
             if( ctsPeriod == sim::zero() )
                 return;	// output disabled
+            ostream& out = live ? static_cast<ostream&>(ctsOStream) : buffer;
             if( !duringInit ){
                 if( sim::intervTime() < sim::zero()
                     || mod_nn(sim::intervTime(), ctsPeriod) != sim::zero() )
@@ -179,24 +305,35 @@ namespace OM {
             } else {
                 if( mod_nn(sim::now(), ctsPeriod) != sim::zero() )
                     return;
-                ctsOStream << sim::inSteps(sim::now()) << '\t';
+                out << sim::inSteps(sim::now()) << '\t';
             }
 
             if( duringInit && sim::intervTime() < sim::zero() ){
-                ctsOStream << "nan";
+                out << "nan";
             }else{
                 // NOTE: we could switch this to output dates, but (1) it would be
                 // breaking change and (2) it may be harder to use.
-                ctsOStream << sim::inSteps(sim::intervTime());
+                out << sim::inSteps(sim::intervTime());
+            }
+            if( !toAdd.empty() ){
+                for( Host::Human& human : population.humans ){
+                    for( const auto& add : toAdd ) add( human );
+                }
             }
             for( size_t i = 0; i < toReport.size(); ++i )
-                std::get<1>(toReport[i])( population, ctsOStream );
-
-            // We must flush often to avoid temporarily outputting partial lines
-            // (resulting in incorrect real-time graphs).
-            ctsOStream << mon::lineEnd << flush;
+                std::get<1>(toReport[i])( population, out );
 
-            streamOff = ctsOStream.tellp() - streamStart;
+            if( live ){
+                // We must flush often to avoid temporarily outputting partial lines
+                // (resulting in incorrect real-time graphs).
+                ctsOStream << mon::lineEnd << flush;
+                streamOff = ctsOStream.tellp() - streamStart;
+            }else{
+                // Only whole lines are passed to the writer
+                buffer << mon::lineEnd;
+                streamOff = bufferOff + buffer.tellp();
+                if( buffer.tellp() >= BLOCK_SIZE ) flushBuffer();
+            }
         }
     }
 }
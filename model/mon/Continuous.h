@@ -76,11 +76,22 @@ namespace mon {
     void registerCallback (string optName, string titles, function<void(const vector<Host::Human> &, ostream&)> f);
 
     void registerCallback (string optName, string titles, function<void(Population &, ostream&)> f);
+
+	/** Register an output computed over all humans.
+	 *
+	 * Before output is written, add is called for every human; one pass
+	 * over the population serves all such outputs. f should then write the
+	 * output (as above) and reset whatever add accumulates. */
+    void registerCallback (string optName, string titles, function<void(Host::Human&)> add,
+            function<void(Population &, ostream&)> f);
 	
 	/// Generate time-step's output. Called at beginning of time step.
         /// Passed population since some callbacks use this to generate output.
 	void update (Population &population);
         
+        /// Write all remaining output. Call at the end of the simulation.
+        void finish ();
+        
     private:
         void checkpoint(ostream& stream);
         void checkpoint(istream& stream);
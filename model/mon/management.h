@@ -49,10 +49,18 @@ void initCohorts( const scnXml::Monitoring& monitoring );
 /// Call just before the start of the intervention period
 void initMainSim();
 
-/// Call after all data for some survey number has been provided
+/** Call after all data for some survey number has been provided.
+ * 
+ * With streaming output (--stream-output), this also writes surveys which can
+ * no longer receive reports. */
 void concludeSurvey();
 
-/// Write survey data to output.txt (or configured file)
+/** With streaming output, do not write survey number `survey` or any later
+ * survey at the next concludeSurvey(), since a pending report may still be
+ * made to it. Call while summarizing (before concludeSurvey()). */
+void holdSurvey( size_t survey );
+
+/// Write survey data to output.txt (or output.bin, or the configured file)
 void writeSurveyData();
 
 // Checkpointing
@@ -61,8 +69,26 @@ void checkpoint( std::istream& stream );
 
 // Functions for internal use (within mon package)
 namespace internal{
-    // Write results to stream
-    void write( std::ostream& stream );
+    // Write results of surveys first to end - 1 to stream
+    void write( std::ostream& stream, size_t first, size_t end );
+    // Write the infant mortality rate (if reported), after all surveys
+    void writeIMR( std::ostream& stream );
+    
+    // Binary output (--binary-output): write the header describing the
+    // stored values, values of surveys first to end - 1 and the infant
+    // mortality rate (written even if not reported)
+    void writeBinaryHeader( std::ostream& stream );
+    void writeBinary( std::ostream& stream, size_t first, size_t end );
+    void writeBinaryIMR( std::ostream& stream );
+    
+    // Make sure results up to and including some survey can be stored
+    void extend( size_t survey );
+    // Discard stored results of surveys before end
+    void discard( size_t end );
+    
+    // Checkpoint the streaming output state
+    void checkpointOutput( std::ostream& stream );
+    void checkpointOutput( std::istream& stream );
     
     /** Get the output cohort set numeric identifier given the internal one
      * (as returned by Survey::updateCohortSet()). */
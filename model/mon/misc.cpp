@@ -31,9 +31,11 @@
 #include "schema/monitoring.h"
 
 #include "Host/WithinHost/Diagnostic.h"
+#include "Clinical/ClinicalModel.h"
 
 #include <gzstream/gzstream.h>
 #include <fstream>
+#include <cstdio>
 
 namespace OM {
 namespace mon {
@@ -60,6 +62,12 @@ namespace impl{
 
 void updateConditions();        // defined in mon.cpp
 
+// Streaming output: surveys are written to a temporary file as they are
+// finished, which is renamed to the output file at the end.
+fstream partStream;
+size_t nWritten = 0;    // number of surveys written to partStream
+size_t heldSurvey = NOT_USED;   // first survey not to write (see holdSurvey)
+
 // trim from start (in place)
 static inline void ltrim(std::string &s) {
     s.erase(s.begin(), std::find_if(s.begin(), s.end(), [](unsigned char ch) {
@@ -179,26 +187,87 @@ void updateSurveyNumbers() {
         const SurveyDate& nextSurvey = impl::surveyDates[impl::surveyIndex];
         impl::survNumStat = nextSurvey.num;     // may be NOT_USED; this is intended
         impl::nextSurveyDate = nextSurvey.date;
+        // survNumStat is either NOT_USED or equal to survNumEvent
+        if( impl::survNumEvent != NOT_USED ) internal::extend( impl::survNumEvent );
+    }
+}
+
+string partName(){
+    return util::CommandLine::getOutputName() + ".part";
+}
+inline bool binaryOutput(){
+    return util::CommandLine::option( util::CommandLine::BINARY_OUTPUT );
+}
+// Write the start of the output file (only used by the binary format)
+void writeHeader(ostream& stream) {
+    if( binaryOutput() ) internal::writeBinaryHeader( stream );
+}
+void writeToStream(ostream& stream, size_t first, size_t end) {
+    if( binaryOutput() ){
+        internal::writeBinary( stream, first, end );
+        return;
+    }
+    stream.width (0);
+    // For additional control:
+    // stream.precision (6);
+    // stream << scientific;
+    
+    internal::write( stream, first, end );
+}
+// Write what comes after all surveys
+void writeEnd(ostream& stream) {
+    if( binaryOutput() ) internal::writeBinaryIMR( stream );
+    else internal::writeIMR( stream );
+}
+void openPartStream(){
+    partStream.open( partName(), ios::out | ios::binary );
+    if( partStream.fail() )
+        throw util::base_exception( "unable to write " + partName(), util::Error::FileIO );
+    writeHeader( partStream );
+}
+/* Write surveys which can no longer receive reports, then discard them.
+ * 
+ * Episodes are reported to the survey during which they started and may
+ * be extended until the health system memory has passed; Host::summarize
+ * reports episodes which can no longer be extended. Thus no report can be
+ * made to a survey dated at least that long ago, except to surveys held by
+ * holdSurvey() for episodes which could not be reported early. */
+void writeFinishedSurveys(){
+    const SimTime lastFinished = sim::now() - Clinical::ClinicalModel::hsMemory();
+    size_t end = nWritten;
+    for( const SurveyDate& survey : impl::surveyDates ){
+        if( survey.date > lastFinished ) break;
+        if( survey.isReported() ) end = survey.num + 1;
     }
+    end = min( end, heldSurvey );
+    heldSurvey = NOT_USED;      // set again by the next summary
+    if( end <= nWritten ) return;
+    
+    if( !partStream.is_open() ) openPartStream();
+    writeToStream( partStream, nWritten, end );
+    internal::discard( end );
+    nWritten = end;
 }
 void initMainSim(){
     impl::surveyIndex = 0;
     impl::isInit = true;
     updateSurveyNumbers();
 }
+void holdSurvey( size_t survey ){
+    heldSurvey = min( heldSurvey, survey );
+}
 void concludeSurvey(){
     updateConditions();
     impl::surveyIndex += 1;
     updateSurveyNumbers();
+    if( util::CommandLine::option( util::CommandLine::STREAM_OUTPUT ) )
+        writeFinishedSurveys();
 }
 
 void writeToStream(ostream& stream) {
-    stream.width (0);
-    // For additional control:
-    // stream.precision (6);
-    // stream << scientific;
-    
-    internal::write( stream );
+    writeHeader( stream );
+    writeToStream( stream, 0, impl::nSurveys );
+    writeEnd( stream );
 }
 
 void writeSurveyData ()
@@ -206,7 +275,17 @@ void writeSurveyData ()
     string filename = util::CommandLine::getOutputName();
     auto mode = std::ios::out | std::ios::binary;
     
-    if (util::CommandLine::option( util::CommandLine::COMPRESS_OUTPUT )) {
+    if (util::CommandLine::option( util::CommandLine::STREAM_OUTPUT )) {
+        if( !partStream.is_open() ) openPartStream();
+        if( impl::nSurveys > 0 ) internal::extend( impl::nSurveys - 1 );
+        writeToStream( partStream, nWritten, impl::nSurveys );
+        writeEnd( partStream );
+        nWritten = impl::nSurveys;
+        partStream.close();
+        std::remove( filename.c_str() );    // rename may not replace on Windows
+        if( partStream.fail() || std::rename( partName().c_str(), filename.c_str() ) != 0 )
+            throw util::base_exception( "unable to write " + filename, util::Error::FileIO );
+    } else if (util::CommandLine::option( util::CommandLine::COMPRESS_OUTPUT )) {
         filename.append(".gz");
         ogzstream stream(filename.c_str(), mode);
         writeToStream(stream);
@@ -226,6 +305,31 @@ void writeSurveyData ()
 }
 
 
+void internal::checkpointOutput( ostream& stream ){
+    nWritten & stream;
+    streamoff pos = 0;
+    if( partStream.is_open() ){
+        partStream.flush();
+        pos = partStream.tellp();
+    }
+    pos & stream;
+}
+void internal::checkpointOutput( istream& stream ){
+    nWritten & stream;
+    streamoff pos;
+    pos & stream;
+    if( partStream.is_open() ) partStream.close();
+    if( pos > 0 ){
+        // Resume writing where the checkpoint was made (as for ctsout.txt,
+        // anything written after the checkpoint will be repeated)
+        partStream.open( partName(), ios::binary | ios::in | ios::out );
+        partStream.seekp( pos, ios_base::beg );
+        if( partStream.fail() )
+            throw util::checkpoint_error( "mon: resume error (bad " + partName() + ")" );
+    }
+}
+
+
 // ———  AgeGroup  ———
 
 vector<SimTime> AgeGroup::upperBound;
@@ -29,10 +29,13 @@
 #include "Host/WithinHost/Genotypes.h"
 #include "Clinical/ClinicalModel.h"
 #include "Host/Human.h"
+#include "util/CommandLine.h"
 #include "util/errors.h"
+#include "util/parallel.h"
 #include "schema/scenario.h"
 
 #include <typeinfo>
+#include <type_traits>
 #include <iostream>
 
 namespace OM {
@@ -175,11 +178,76 @@ struct MonIndByMeasure{
     }
 } monIndByMeasure;
 
+// Per-thread accumulators used by Store while humans are updated in parallel.
+// Each chunk gets a buffer of `surveySize` values per survey reported to
+// (normally only the current survey, plus the previous one for events reported
+// just after a survey). Buffers are added into `reports` in chunk order.
+template<typename T>
+class ShadowReports : public util::parallel::Mergeable {
+public:
+    ShadowReports( vector<T>& reports, const size_t& surveySize, const size_t& firstSurvey ) :
+        reports(reports), surveySize(surveySize), firstSurvey(firstSurvey) {}
+    
+    // Add val to the value at `offset` within `survey`, for the given chunk
+    inline void add( size_t chunk, size_t survey, size_t offset, T val ){
+        vector<Block>& blocks = chunks[chunk];
+        for( Block& b : blocks ){
+            if( b.survey == survey ){
+                b.values[offset] += val;
+                return;
+            }
+        }
+        for( Block& b : blocks ){
+            if( b.survey == NOT_USED ){
+                b.survey = survey;
+                b.values.assign( surveySize, 0 );
+                b.values[offset] += val;
+                return;
+            }
+        }
+        blocks.push_back( Block{ survey, vector<T>( surveySize, 0 ) } );
+        blocks.back().values[offset] += val;
+    }
+    
+    virtual void prepare( size_t nChunks ){
+        if( chunks.size() < nChunks ) chunks.resize( nChunks );
+    }
+    virtual void merge(){
+        for( vector<Block>& blocks : chunks ){
+            for( Block& b : blocks ){
+                if( b.survey == NOT_USED ) continue;
+                T *dest = &reports[(b.survey - firstSurvey) * surveySize];
+                for( size_t i = 0; i < surveySize; ++i ) dest[i] += b.values[i];
+                b.survey = NOT_USED;     // keep memory for the next step
+            }
+        }
+    }
+    
+private:
+    struct Block {
+        size_t survey;
+        vector<T> values;
+    };
+    vector<T>& reports;
+    const size_t& surveySize;
+    const size_t& firstSurvey;
+    vector<vector<Block>> chunks;
+};
+
+// Write a value to binary output (in native byte order)
+template<typename T>
+inline void writeBinaryValue( ostream& stream, T value ){
+    stream.write( reinterpret_cast<const char*>( &value ), sizeof(T) );
+}
+
 // Store data of type T which is to be reported
 template<typename T>
 class Store{
 public:
-    Store() : surveySize(0) {}
+    Store() : surveySize(0), firstSurvey(0), nResident(0),
+        shadows( reports, surveySize, firstSurvey ),
+        journal( [this]( const pair<size_t, T>& r ){ reports[r.first] += r.second; } )
+    {}
     
 private:
     // This lists all enabled outputs, sorted by `measure` (first field, of
@@ -194,12 +262,42 @@ private:
     
     // Number of indices in `reports` used by a single survey
     size_t surveySize;
+    // Surveys stored in `reports` are `firstSurvey` to `firstSurvey + nResident - 1`.
+    // Normally these are all surveys; with streaming output, surveys already
+    // written are discarded and surveys are added as reporting reaches them.
+    size_t firstSurvey, nResident;
     // These are the stored reports (multidimensional; size is `size()` and
-    // indices are `survey * surveySize + measures[m].index(...)` for some `m`).
+    // indices are `slot(survey) + measures[m].index(...)` for some `m`).
     vector<T> reports;
     
+    // Integer sums are exact in any order, so in parallel sections these use
+    // per-thread buffers. Floating-point sums depend on order; to keep output
+    // independent of the number of threads these are instead journaled as
+    // (index, value) and replayed in the same order as a serial update.
+    static const bool exactSum = std::is_integral<T>::value;
+    ShadowReports<T> shadows;
+    util::parallel::Journal<pair<size_t, T>> journal;
+    
+    // Add val to reports at the given survey and index (within the survey)
+    inline void add( size_t survey, size_t index, T val ){
+        const size_t chunk = util::parallel::chunk();
+        if( chunk == util::parallel::SERIAL ){
+            reports[slot(survey) + index] += val;
+        }else if( exactSum ){
+            shadows.add( chunk, survey, index, val );
+        }else{
+            journal.defer( make_pair(slot(survey) + index, val) );
+        }
+    }
+    
+    // Index in reports of the first value of some survey
+    inline size_t slot( size_t survey ) const{
+        assert( survey >= firstSurvey && survey < firstSurvey + nResident );
+        return (survey - firstSurvey) * surveySize;
+    }
+    
     // get size of reports
-    inline size_t size(){ return surveySize * impl::nSurveys; }
+    inline size_t size(){ return surveySize * nResident; }
     
 public:
     // Set up ready to accept reports. The passed list includes all measures
@@ -226,6 +324,8 @@ public:
         
         sortEnabledMeasures();
         
+        // With streaming output, surveys are added by extend()
+        nResident = util::CommandLine::option( util::CommandLine::STREAM_OUTPUT ) ? 0 : impl::nSurveys;
         // Leave a few spare slots for potential conditions using variables not already reported:
         reports.reserve(size() + 12);
         reports.assign(size(), 0);
@@ -301,10 +401,9 @@ public:
             assert(ind.measure == measure);
             if( ind.deployMask != Deploy::NA ) continue;        // skip measures tracking deployments
             if( outId != 0 && ind.outMeasure != outId) continue;     // skip if supplied outID is different
-            size_t index = survey * surveySize +
-                    ind.index(ageIndex, cohortSet, species, genotype, drug);
-            assert( index < reports.size() );
-            reports[index] += val;
+            size_t index = ind.index(ageIndex, cohortSet, species, genotype, drug);
+            assert( slot(survey) + index < reports.size() );
+            add( survey, index, val );
         }
     }
     
@@ -327,10 +426,9 @@ public:
             if( (ind.deployMask & method) == Deploy::NA ) continue;
             assert( ind.nSpecies == 1 && ind.nGenotypes == 1 );     // never used for deployments
             
-            size_t index = survey * surveySize +
-                    ind.index(ageIndex, cohortSet, 0, 0, 0);
-            assert( index < reports.size() );
-            reports[index] += val;
+            size_t index = ind.index(ageIndex, cohortSet, 0, 0, 0);
+            assert( slot(survey) + index < reports.size() );
+            add( survey, index, val );
         }
     }
     
@@ -350,7 +448,7 @@ public:
             assert(ind.measure == measure);
             if( ind.deployMask != method ) continue;    // incompatible deployment mode: skip
             
-            const size_t off = survey * surveySize + ind.offset;
+            const size_t off = slot(survey) + ind.offset;
             T sum = 0;
             size_t end2 = off + ind.size();
             assert(end2 <= reports.size());
@@ -369,40 +467,85 @@ public:
         return measure_map[measure].second > measure_map[measure].first;
     }
     
-    // Write stored values to stream for some output measure, om
-    void write( ostream& stream, size_t survey, const OutMeasure& om ){
+    // Find the records used to output some measure, om
+    const MonIndex& find( const OutMeasure& om ) const{
         assert(om.m < measure_map.size());
         for( size_t i = measure_map[om.m].first, end = measure_map[om.m].second;
             i < end; ++i )
         {
             assert(i < measures.size());
-            if( measures[i].outMeasure == om.outId ){
-                measures[i].write( stream, survey + 1, om, reports, survey * surveySize );
-                return;
-            }
+            if( measures[i].outMeasure == om.outId ) return measures[i];
         }
         assert(false && "measure not found in records");
+        throw SWITCH_DEFAULT_EXCEPTION;
+    }
+    
+    // Write stored values to stream for some output measure, om
+    void write( ostream& stream, size_t survey, const OutMeasure& om ){
+        find( om ).write( stream, survey + 1, om, reports, slot(survey) );
+    }
+    
+    // Binary output: number of values written per survey
+    inline size_t getSurveySize() const{ return surveySize; }
+    // Binary output: write the description of output measure om
+    void writeBinaryHeader( ostream& stream, const OutMeasure& om ) const{
+        const MonIndex& ind = find( om );
+        const uint32_t flags = (om.byAge ? 1 : 0) | (om.bySpecies ? 2 : 0) | (om.byDrug ? 4 : 0);
+        writeBinaryValue<int32_t>( stream, om.outId );
+        writeBinaryValue<uint32_t>( stream, om.isDouble ? 1 : 0 );
+        writeBinaryValue<uint32_t>( stream, flags );
+        for( size_t n : { ind.offset, ind.nAges, ind.nCohorts, ind.nSpecies, ind.nGenotypes, ind.nDrugs } ){
+            writeBinaryValue<uint32_t>( stream, n );
+        }
+    }
+    // Binary output: write all values of a survey, as stored
+    void writeBinary( ostream& stream, size_t survey ) const{
+        static_assert( sizeof(T) == 4 || sizeof(T) == 8, "binary output stores int32 or float64" );
+        if( surveySize == 0 ) return;
+        stream.write( reinterpret_cast<const char*>( &reports[slot(survey)] ),
+                      surveySize * sizeof(T) );
+    }
+    
+    // Make sure surveys up to and including `survey` are stored
+    void extend( size_t survey ){
+        if( survey < firstSurvey + nResident ) return;
+        nResident = survey + 1 - firstSurvey;
+        reports.resize( size(), 0 );
+    }
+    // Discard surveys before `end` (these must have been written)
+    void discard( size_t end ){
+        if( end <= firstSurvey ) return;
+        const size_t n = min( end - firstSurvey, nResident );
+        reports.erase( reports.begin(), reports.begin() + n * surveySize );
+        firstSurvey = end;
+        nResident -= n;
     }
     
     // Checkpointing
     void checkpoint( ostream& stream ){
+        firstSurvey & stream;
+        nResident & stream;
         reports.size() & stream;
         for (T& y : reports) {
             y & stream;
         }
-        // reports is the only field which changes after initialisation
+        // reports and the range of surveys stored are the only fields which
+        // change after initialisation
     }
     void checkpoint( istream& stream ){
+        firstSurvey & stream;
+        nResident & stream;
         size_t l;
         l & stream;
-        if( l != size() ){
+        if( l != size() || firstSurvey + nResident > impl::nSurveys ){
             throw util::checkpoint_error( "mon::reports: invalid list size" );
         }
         reports.resize (l);
         for (T& y : reports) {
             y & stream;
         }
-        // reports is the only field which changes after initialisation
+        // reports and the range of surveys stored are the only fields which
+        // change after initialisation
     }
 };
 
@@ -554,8 +697,8 @@ bool checkCondition( size_t conditionKey ){
     return impl::conditions[conditionKey].value;
 }
 
-void internal::write( ostream& stream ){
-    for( size_t survey = 0; survey < impl::nSurveys; ++survey ){
+void internal::write( ostream& stream, size_t first, size_t end ){
+    for( size_t survey = first; survey < end; ++survey ){
         for( const OutMeasure& om : reportedMeasures ){
             if( om.m >= M_NUM ){
                 // "Special" measures are not reported this way. The only such measure is IMR.
@@ -568,6 +711,8 @@ void internal::write( ostream& stream ){
             }
         }
     }
+}
+void internal::writeIMR( ostream& stream ){
     if( reportIMR >= 0 ){
         // Infant mortality rate is a single number, therefore treated specially.
         // It is calculated across the entire intervention period and used in
@@ -577,6 +722,55 @@ void internal::write( ostream& stream ){
     }
 }
 
+/* Binary output. All values are in the byte order of the writing machine;
+ * readers can detect this from the version number. The layout is:
+ * 
+ *  char[8] "OMOUTBIN", uint32 version (1), uint32 number of surveys
+ *  uint32 number of cohort sets, then the output id of each (uint32)
+ *  uint32 number of int32 values per survey, then of float64 values
+ *  uint32 number of measures, then for each (ordered by output id):
+ *      int32 output id, uint32 type (0: int32, 1: float64),
+ *      uint32 flags (1: by age, 2: by species, 4: by drug),
+ *      uint32 offset (within the survey's values of this type), then
+ *      uint32 number of age groups, cohort sets, species, genotypes, drugs
+ *  for each survey, the int32 then the float64 values
+ *  int32 output id of the infant mortality rate (-1 if none), float64 rate
+ * 
+ * Values of a measure are stored at offset + (((age * cohort sets + cohort)
+ * * species + species) * genotypes + genotype) * drugs + drug. When there is
+ * more than one age group, the last (individuals too old) is not reported. */
+void internal::writeBinaryHeader( ostream& stream ){
+    stream.write( "OMOUTBIN", 8 );
+    writeBinaryValue<uint32_t>( stream, 1 );
+    writeBinaryValue<uint32_t>( stream, impl::nSurveys );
+    writeBinaryValue<uint32_t>( stream, impl::nCohorts );
+    for( uint32_t cohortSet = 0; cohortSet < impl::nCohorts; ++cohortSet ){
+        writeBinaryValue<uint32_t>( stream, internal::cohortSetOutputId( cohortSet ) );
+    }
+    writeBinaryValue<uint32_t>( stream, storeI.getSurveySize() );
+    writeBinaryValue<uint32_t>( stream, storeF.getSurveySize() );
+    uint32_t nMeasures = 0;
+    for( const OutMeasure& om : reportedMeasures ){
+        if( om.m < M_NUM ) nMeasures += 1;
+    }
+    writeBinaryValue<uint32_t>( stream, nMeasures );
+    for( const OutMeasure& om : reportedMeasures ){
+        if( om.m >= M_NUM ) continue;   // IMR
+        else if( om.isDouble ) storeF.writeBinaryHeader( stream, om );
+        else storeI.writeBinaryHeader( stream, om );
+    }
+}
+void internal::writeBinary( ostream& stream, size_t first, size_t end ){
+    for( size_t survey = first; survey < end; ++survey ){
+        storeI.writeBinary( stream, survey );
+        storeF.writeBinary( stream, survey );
+    }
+}
+void internal::writeBinaryIMR( ostream& stream ){
+    writeBinaryValue<int32_t>( stream, reportIMR );
+    writeBinaryValue<double>( stream, reportIMR >= 0 ? Clinical::InfantMortality::allCause() : 0.0 );
+}
+
 // Report functions: each reports to all usable stores (i.e. correct data type
 // and where parameters don't have to be fabricated).
 // void reportMI( Measure measure, int val ){
@@ -670,6 +864,15 @@ void reportStatMSGF( Measure measure, size_t species, size_t genotype, double va
     storeF.report( val, measure, survey, 0, 0, species, genotype, 0 );
 }
 
+void internal::extend( size_t survey ){
+    storeI.extend( survey );
+    storeF.extend( survey );
+}
+void internal::discard( size_t end ){
+    storeI.discard( end );
+    storeF.discard( end );
+}
+
 bool isUsedM( Measure measure ){
     return storeI.isUsed(measure) || storeF.isUsed(measure);
 }
@@ -683,6 +886,7 @@ void checkpoint( ostream& stream ){
     
     storeI.checkpoint(stream);
     storeF.checkpoint(stream);
+    internal::checkpointOutput(stream);
 }
 void checkpoint( istream& stream ){
     impl::isInit & stream;
@@ -693,6 +897,7 @@ void checkpoint( istream& stream ){
     
     storeI.checkpoint(stream);
     storeF.checkpoint(stream);
+    internal::checkpointOutput(stream);
 }
 
 }
@@ -290,6 +290,17 @@ namespace OM { namespace util {
             obj = new AgeGroupPiecewiseConstant( ageGroups, eltName );
         }else
             throw util::xml_scenario_error(string("age group interpolation ") + interp.get() + " not implemented" );
+        
+        if( util::CommandLine::option(util::CommandLine::TABULATE_AGE_GROUPS) ){
+            tabulate();
+        }
+    }
+    void AgeGroupInterpolator::tabulate(){
+        table.resize( sim::inSteps(sim::maxHumanAge()) + 1 );
+        for( size_t i = 0; i < table.size(); ++i ){
+            table[i] = obj->eval( sim::inYears( sim::fromTS( static_cast<int>(i) ) ) );
+        }
+        stepsPerYear = static_cast<double>(sim::DAYS_IN_YEAR) / sim::oneTS();
     }
     void AgeGroupInterpolator::reset(){
         assert( obj != nullptr );  // should not do that
@@ -297,6 +308,7 @@ namespace OM { namespace util {
             delete obj;
             obj = &AgeGroupDummy::singleton;
         }
+        table.clear();
     }
     bool AgeGroupInterpolator::isSet()    {
         return obj != &AgeGroupDummy::singleton;
@@ -49,8 +49,8 @@ protected:
 /** A class representing deterministic interpolation of data collected
  * according to age groups. Derived classes implement the actual interpolation.
  * 
- * Current version does not store an age index, thus an order log(n) lookup
- * must occur each time a value is looked up.
+ * Without tabulate(), an order log(n) lookup must occur each time a value is
+ * looked up.
  ********************************************/
 struct AgeGroupInterpolator
 {
@@ -71,14 +71,32 @@ struct AgeGroupInterpolator
     /// Return true if set() was ever called.
     bool isSet();
     
-    /** Return a value interpolated for age ageYears. */
+    /** Precompute values for every age on the time-step grid, up to
+     * sim::maxHumanAge(). set() does this when the --tabulate-age-groups
+     * option is given; scale() updates the table.
+     * 
+     * Call after set() and sim::init(). */
+    void tabulate();
+    
+    /** Return a value interpolated for age ageYears.
+     * 
+     * If tabulated and ageYears is exactly sim::inYears(t) for a whole number
+     * of time steps t (as for ages of humans at ts0 or ts1), the result is
+     * taken from the table and is identical to the untabulated result. */
     inline double eval( double ageYears )const{
+        if( !table.empty() ){
+            const long steps = std::lround( ageYears * stepsPerYear );
+            if( steps >= 0 && static_cast<size_t>(steps) < table.size() &&
+                sim::inYears( sim::fromTS( static_cast<int>(steps) ) ) == ageYears )
+                return table[steps];
+        }
         return obj->eval( ageYears );
     }
     
     /** Scale function by factor. */
     inline void scale( double factor ){
         obj->scale( factor );
+        if( !table.empty() ) tabulate();
     }
 
     /** Find the youngest age which is the global maximum (i.e. the age at
@@ -90,6 +108,10 @@ struct AgeGroupInterpolator
     
 private:
     AgeGroupInterpolation *obj;
+    
+    // If tabulated, the value at age i time steps is table[i]
+    vector<double> table;
+    double stepsPerYear = 0.0;
 };
 
 } }
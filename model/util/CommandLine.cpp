@@ -38,6 +38,10 @@ namespace OM { namespace util {
 	string CommandLine::outputName;
 	string CommandLine::ctsoutName;
 	string CommandLine::checkpointFileName;
+	string CommandLine::checkpointEvery;
+	string CommandLine::warmupCacheDir;
+	size_t CommandLine::numThreads = 1;
+	size_t CommandLine::ensembleSize = 1;
 
 	string parseNextArg (int argc, char* argv[], int& i) {
 		++i;
@@ -60,6 +64,20 @@ namespace OM { namespace util {
 		return ret;
 	}
 
+	// Insert suffix before the extension of the file name in path, if any
+	void insertSuffix (string& path, const string& suffix) {
+		size_t dot = path.find_last_of ('.');
+		size_t slash = path.find_last_of ("/\\");
+		if (dot == string::npos || (slash != string::npos && dot < slash))
+			dot = path.size();
+		path.insert (dot, suffix);
+	}
+
+	void CommandLine::addOutputSuffix (const string& suffix) {
+		insertSuffix (outputName, suffix);
+		insertSuffix (ctsoutName, suffix);
+	}
+
 	string CommandLine::parse (int argc, char* argv[]) {
 		bool cloHelp = false, cloVersion = false, cloError = false;
 		string scenarioFile = "";
@@ -100,11 +118,17 @@ namespace OM { namespace util {
 					outputName = parseNextArg (argc, argv, i);
 				} else if (clo == "compress-output") {
 					options.set (COMPRESS_OUTPUT);
+				} else if (clo == "stream-output") {
+					options.set (STREAM_OUTPUT);
+				} else if (clo == "binary-output") {
+					options.set (BINARY_OUTPUT);
 				} else if (clo == "ctsout") {
 					if (ctsoutName != ""){
 						throw cmd_exception ("--ctsout argument may only be given once");
 					}
 					ctsoutName = parseNextArg (argc, argv, i);
+				} else if (clo == "ctsout-live") {
+					options.set (CTSOUT_LIVE);
 				} else if (clo == "name") {
 					if (ctsoutName != "" || outputName != "" || scenarioFile != ""){
 						throw cmd_exception ("--name may not be used along with --scenario, --output or --ctsout");
@@ -143,11 +167,46 @@ namespace OM { namespace util {
 					}
 					options.set (CHECKPOINT);
 					checkpointFileName = parseNextArg (argc, argv, i);
+				} else if (clo == "checkpoint-every") {
+					if (checkpointEvery != ""){
+						throw cmd_exception ("--checkpoint-every argument may only be given once");
+					}
+					options.set (CHECKPOINT);
+					checkpointEvery = parseNextArg (argc, argv, i);
 				} else if (clo == "checkpoint-stop") {
 					options.set (CHECKPOINT);
 					options.set (CHECKPOINT_STOP);
+				} else if (clo == "warmup-cache") {
+					if (warmupCacheDir != ""){
+						throw cmd_exception ("--warmup-cache argument may only be given once");
+					}
+					warmupCacheDir = parseNextArg (argc, argv, i);
+				} else if (clo == "threads") {
+					string arg = parseNextArg (argc, argv, i);
+					size_t pos = 0;
+					long n = -1;
+					try{
+						n = std::stol (arg, &pos);
+					}catch( const std::exception& ){}
+					if (n < 0 || pos != arg.size())
+						throw cmd_exception ("--threads expects a non-negative integer");
+					numThreads = n;
+				} else if (clo == "ensemble") {
+					string arg = parseNextArg (argc, argv, i);
+					size_t pos = 0;
+					long n = -1;
+					try{
+						n = std::stol (arg, &pos);
+					}catch( const std::exception& ){}
+					if (n < 1 || pos != arg.size())
+						throw cmd_exception ("--ensemble expects a positive integer");
+					ensembleSize = n;
 				} else if (clo == "debug-vector-fitting") {
 					options.set (DEBUG_VECTOR_FITTING);
+				} else if (clo == "pkpd-qag") {
+					options.set (PKPD_QAG);
+				} else if (clo == "tabulate-age-groups") {
+					options.set (TABULATE_AGE_GROUPS);
 #	ifdef OM_STREAM_VALIDATOR
 				} else if (clo == "stream-validator") {
 					if (sVFile.size())
@@ -237,9 +296,23 @@ namespace OM { namespace util {
 		<< "			If path is relative (doesn't start '/'), --resource-path is used."<<endl
 		<< " -o --output file.txt	Uses file.txt as output file name. If not given, output.txt is used." << endl
 		<< "    --ctsout file.txt	Uses file.txt as ctsout file name. If not given, ctsout.txt is used." << endl
+		<< "    --ctsout-live	Write each line of ctsout.txt as soon as it is ready (for" << endl
+		<< "			watching output during the simulation). By default, lines are" << endl
+		<< "			written in large blocks by a background thread." << endl
 		<< " -n --name NAME		Equivalent to --scenario scenarioNAME.xml --output outputNAME.txt \\"<<endl
 		<< "			--ctsout ctsoutNAME.txt" <<endl
 		<< " -z --compress-output	Compress output with gzip (writes output.txt.gz)." << endl
+		<< "    --stream-output	Write each survey to output.txt.part once complete, instead of" << endl
+		<< "			keeping all surveys in memory; this is renamed to output.txt at" << endl
+		<< "			the end. Output is identical. Not usable with --compress-output." << endl
+		<< "    --binary-output	Write survey output in a compact binary format to output.bin" << endl
+		<< "			(or the file given by --output); see util/readOutput.py." << endl
+		<< "    --threads N		Update humans using N threads (default 1; 0 uses one per" << endl
+		<< "			hardware thread). Results do not depend on N." << endl
+		<< "    --ensemble K	Run K replicates with seeds iseed, iseed+1, ..., iseed+K-1" << endl
+		<< "			(iseed from the scenario) in parallel processes, sharing the" << endl
+		<< "			initialisation. Replicates other than the first write output" << endl
+		<< "			to e.g. output_seed7.txt. Not usable with checkpointing." << endl
 		<< "    --validate-only	Initialise and validate scenario, but don't run simulation." << endl
 		<< "    --no-deprecation-warnings" << endl
 		<< "			OpenMalaria warn about the use of features deemed error-prone and where" << endl
@@ -262,10 +335,24 @@ namespace OM { namespace util {
 		<< "			simulations differ only during the intervention phase."<<endl
 		<< "    --checkpoint-file file	Checkpoint as above. Uses file as checkpoint file name. If not given, checkpoint is used." << endl
 		<< "    --checkpoint-stop	Checkpoint as above, then stop immediately afterwards. Can be used with --checkpoint-file."<<endl
+		<< "    --checkpoint-every DURATION" << endl
+		<< "			Checkpoint as above, and also every DURATION (e.g. 1y or 90d) of" << endl
+		<< "			the intervention period. The simulation continues while the" << endl
+		<< "			checkpoint is compressed and written. With --checkpoint-stop, stop" << endl
+		<< "			after each of these checkpoints too." << endl
+		<< "    --warmup-cache DIR	Save the state at the end of the warmup in directory DIR, and" << endl
+		<< "			skip the warmup when a saved state for an equivalent scenario" << endl
+		<< "			exists. Scenarios are equivalent when they differ only in human" << endl
+		<< "			intervention deployments, changeHS or importedInfections." << endl
 		<< "    --debug-vector-fitting"<<endl
 		<< "			Show details of vector-parameter fitting. The fitting methods used" <<endl
 		<< "			aren't guaranteed to work. If they don't, this output should help"<<endl
 		<< "			work out why."<<endl
+		<< "    --pkpd-qag		Integrate drug killing with GSL's adaptive QAG routine only" << endl
+		<< "			(slower; results should be identical). For validation." << endl
+		<< "    --tabulate-age-groups" << endl
+		<< "			Precompute age-group interpolations (e.g. body mass, case" << endl
+		<< "			fatality) for each age in time steps; results are identical." << endl
 #	ifdef OM_STREAM_VALIDATOR
 		<< "    --stream-validator PATH" <<endl
 		<< "			Use StreamValidator to validate against reference file PATH." <<endl
@@ -284,13 +371,26 @@ namespace OM { namespace util {
 #	ifdef OM_STREAM_VALIDATOR
 	if( sVFile.size() )
 		StreamValidator.loadStream( sVFile );
+	if( numThreads != 1 )
+		throw cmd_exception( "--threads is not supported with the stream validator" );
 #	endif
 	
+	if (options.test (STREAM_OUTPUT) && options.test (COMPRESS_OUTPUT))
+		throw cmd_exception ("--stream-output may not be used with --compress-output");
+	
+	if (ensembleSize > 1){
+		if (options.test (CHECKPOINT) || warmupCacheDir != "")
+			throw cmd_exception ("--ensemble may not be used with checkpointing or --warmup-cache");
+#	ifdef _WIN32
+		throw cmd_exception ("--ensemble is not supported on Windows");
+#	endif
+	}
+	
 	if (scenarioFile == ""){
 		scenarioFile = "scenario.xml";
 	}
 	if (outputName == ""){
-		outputName = "output.txt";
+		outputName = options.test (BINARY_OUTPUT) ? "output.bin" : "output.txt";
 	}
 	if (ctsoutName == ""){
 		ctsoutName = "ctsout.txt";
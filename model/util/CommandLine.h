@@ -67,6 +67,21 @@ namespace OM { namespace util {
             /** Print times of all surveys. */
 			PRINT_SURVEY_TIMES,
 			PRINT_GENOTYPES,
+            /** Integrate PK/PD drug killing with GSL's QAG only, without
+             * the built-in Gauss-Kronrod step or caching (for validation). */
+			PKPD_QAG,
+            /** Write each survey to the output file once it is complete,
+             * instead of keeping all results in memory until the end. */
+			STREAM_OUTPUT,
+            /** Write survey output in a binary format (see mon.cpp), to
+             * output.bin unless an output file name is given. */
+			BINARY_OUTPUT,
+            /** Write and flush each line of continuous output immediately,
+             * instead of writing in blocks from a background thread. */
+			CTSOUT_LIVE,
+            /** Precompute age-group interpolations for every age on the
+             * time-step grid (see AgeGroupInterpolator::tabulate()). */
+			TABULATE_AGE_GROUPS,
 			NUM_OPTIONS
 		};
 
@@ -93,6 +108,32 @@ namespace OM { namespace util {
 			return checkpointFileName;
 		}
 
+    /** Get the interval between checkpoints during the intervention period,
+     * as given (empty if not used). */
+		static inline string getCheckpointEvery (){
+			return checkpointEvery;
+		}
+
+    /** Get the warmup cache directory (empty if not used). */
+		static inline string getWarmupCacheDir (){
+			return warmupCacheDir;
+		}
+
+    /** Get the number of threads used to update humans (1 unless --threads
+     * was given; 0 means one per hardware thread). */
+		static inline size_t getNumThreads (){
+			return numThreads;
+		}
+
+    /** Get the number of replicates to run (1 unless --ensemble was given). */
+		static inline size_t getEnsembleSize (){
+			return ensembleSize;
+		}
+
+    /** Insert suffix into the output and ctsout file names, before the
+     * extension (used for replicates of an ensemble). */
+		static void addOutputSuffix (const string& suffix);
+
 	/** Looks through all command line options.
 	*
 	* @returns The name of the scenario XML file to use.
@@ -119,6 +160,11 @@ private:
 	static string outputName;
 	static string ctsoutName;
 	static string checkpointFileName;
+	static string checkpointEvery;
+	static string warmupCacheDir;
+	
+	static size_t numThreads;
+	static size_t ensembleSize;
 };
 } }
 #endif
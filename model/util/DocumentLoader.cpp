@@ -22,7 +22,13 @@
 
 #include "util/DocumentLoader.h"
 #include "util/errors.h"
+/* if you get compile errors like "version.h not found", run CMake first */
+#include "util/version.h"
 #include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <cstdint>
 
 namespace OM
 { 
@@ -57,5 +63,146 @@ namespace OM
 
             return scenario;
         }
+
+        namespace {
+            // Two FNV-1a hashes with different offset bases, giving 128 bits
+            struct WarmupHasher {
+                uint64_t h1 = 0xcbf29ce484222325ULL, h2 = 0x6c62272e07bb0142ULL;
+                void add( const char* p, size_t n ){
+                    const uint64_t prime = 0x100000001b3ULL;
+                    for( size_t i = 0; i < n; ++i ){
+                        h1 = (h1 ^ uint8_t(p[i])) * prime;
+                        h2 = (h2 ^ uint8_t(p[i])) * prime;
+                        h2 ^= h2 >> 29;
+                    }
+                }
+                void add( const string& s ){
+                    add( s.data(), s.size() );
+                    add( "\0", 1 );  // separator
+                }
+            };
+
+            // Elements skipped, as paths of local names below the root element
+            const vector<vector<string>> warmupIgnored = {
+                { "interventions", "human", "deployment" },
+                { "interventions", "changeHS" },
+                { "interventions", "importedInfections" }
+            };
+
+            string localName( const string& name ){
+                size_t colon = name.find( ':' );
+                return colon == string::npos ? name : name.substr( colon + 1 );
+            }
+
+            bool isWhitespace( char c ){
+                return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+            }
+
+            // Collapse whitespace runs to a single space and trim
+            string normalise( const string& s ){
+                string r;
+                bool space = false;
+                for( char c : s ){
+                    if( isWhitespace(c) ){
+                        space = !r.empty();
+                    }else{
+                        if( space ) r.push_back( ' ' );
+                        space = false;
+                        r.push_back( c );
+                    }
+                }
+                return r;
+            }
+        }
+
+        string hashScenarioWarmup(string lXmlFile)
+        {
+            ifstream fileStream(lXmlFile.c_str(), ios::binary);
+            if (!fileStream.good())
+            {
+                string msg = "Error: unable to open " + lXmlFile;
+                throw util::xml_scenario_error(msg);
+            }
+            ostringstream buf;
+            buf << fileStream.rdbuf();
+            const string xml = buf.str();
+
+            WarmupHasher hasher;
+            hasher.add( semantic_version );
+
+            vector<string> path;        // local names, excluding the root
+            size_t depth = 0;           // including the root
+            size_t skipDepth = 0;       // if non-zero, skip elements at this depth and below
+            size_t i = 0;
+            while( i < xml.size() ){
+                if( xml[i] != '<' ){
+                    size_t end = xml.find( '<', i );
+                    if( end == string::npos ) end = xml.size();
+                    string text = normalise( xml.substr( i, end - i ) );
+                    if( skipDepth == 0 && !text.empty() ) hasher.add( text );
+                    i = end;
+                }else if( xml.compare( i, 4, "<!--" ) == 0 ){
+                    size_t end = xml.find( "-->", i );
+                    i = end == string::npos ? xml.size() : end + 3;
+                }else if( xml.compare( i, 9, "<![CDATA[" ) == 0 ){
+                    size_t end = xml.find( "]]>", i );
+                    if( end == string::npos ) end = xml.size();
+                    if( skipDepth == 0 ) hasher.add( xml.substr( i + 9, end - i - 9 ) );
+                    i = end + 3;
+                }else if( xml.compare( i, 2, "<?" ) == 0 || xml.compare( i, 2, "<!" ) == 0 ){
+                    size_t end = xml.find( '>', i );
+                    i = end == string::npos ? xml.size() : end + 1;
+                }else{
+                    // element tag: find the end, ignoring '>' within quotes
+                    size_t end = i + 1;
+                    char quote = 0;
+                    while( end < xml.size() && (quote != 0 || xml[end] != '>') ){
+                        if( quote != 0 ){
+                            if( xml[end] == quote ) quote = 0;
+                        }else if( xml[end] == '"' || xml[end] == '\'' ){
+                            quote = xml[end];
+                        }
+                        ++end;
+                    }
+                    if( end >= xml.size() )
+                        throw util::xml_scenario_error( "unterminated tag in " + lXmlFile );
+                    string tag = normalise( xml.substr( i + 1, end - i - 1 ) );
+                    i = end + 1;
+
+                    if( !tag.empty() && tag[0] == '/' ){
+                        if( depth == 0 )
+                            throw util::xml_scenario_error( "unbalanced tags in " + lXmlFile );
+                        if( skipDepth == 0 ) hasher.add( "<" + tag + ">" );
+                        if( skipDepth == depth ) skipDepth = 0;
+                        if( depth > 1 ) path.pop_back();
+                        depth -= 1;
+                        continue;
+                    }
+
+                    bool selfClosing = !tag.empty() && tag.back() == '/';
+                    size_t nameEnd = 0;
+                    while( nameEnd < tag.size() && !isWhitespace(tag[nameEnd]) && tag[nameEnd] != '/' )
+                        ++nameEnd;
+                    depth += 1;
+                    if( depth > 1 ) path.push_back( localName( tag.substr( 0, nameEnd ) ) );
+                    if( skipDepth == 0 ){
+                        for( const vector<string>& ignored : warmupIgnored ){
+                            if( path == ignored ) skipDepth = depth;
+                        }
+                    }
+                    if( skipDepth == 0 ) hasher.add( "<" + tag + ">" );
+                    if( selfClosing ){
+                        if( skipDepth == depth ) skipDepth = 0;
+                        if( depth > 1 ) path.pop_back();
+                        depth -= 1;
+                    }
+                }
+            }
+
+            ostringstream hex;
+            hex << std::hex << std::setfill('0') << std::setw(16) << hasher.h1
+                << std::setw(16) << hasher.h2;
+            return hex.str();
+        }
     }
 }
\ No newline at end of file
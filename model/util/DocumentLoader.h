@@ -38,6 +38,16 @@ namespace OM
         static const int SCHEMA_VERSION = 48;
 
         unique_ptr<scnXml::Scenario> loadScenario(std::string lXmlFile);
+
+        /** Hash the parts of a scenario file which affect the simulation up to
+         * the end of the warmup (initialisation) phase.
+         *
+         * The document is hashed as a sequence of tags, attributes and text,
+         * ignoring comments and formatting whitespace. Intervention elements
+         * only used during the intervention period (human deployments,
+         * changeHS, importedInfections) are skipped. The program version is
+         * included. Returns a hexadecimal string. */
+        std::string hashScenarioWarmup(std::string lXmlFile);
     }
 }
 
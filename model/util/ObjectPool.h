@@ -0,0 +1,169 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2025 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2025 University of Basel
+ * Copyright (C) 2025 The Kids Research Institute Australia
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef Hmod_util_ObjectPool
+#define Hmod_util_ObjectPool
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+namespace OM { namespace util {
+
+/** Free-list allocation for classes whose objects are created and destroyed
+ * very often (infections).
+ *
+ * Objects are carved from slabs of SLAB_SIZE objects. Deleted objects go on a
+ * free list and are reused by the next allocation, so allocation is usually
+ * just a pointer swap and objects stay close together in memory.
+ *
+ * Humans are updated in parallel, so each thread has its own free list (a
+ * cache), and an object may be deleted by a different thread than the one
+ * which created it (e.g. dead humans are removed by the main thread). Caches
+ * are therefore bounded: a thread with more than 2 × SLAB_SIZE free objects
+ * moves SLAB_SIZE of them to a shared free list, and a thread with none
+ * takes up to SLAB_SIZE objects from there before making a new slab. Memory
+ * thus depends on the peak number of live objects, not on where they are
+ * deleted. Slabs are never released (their memory is reused instead).
+ *
+ * Use by deriving T from Pooled<T>. Classes derived from T with a different
+ * size use the global operator new. */
+template<class T>
+class ObjectPool {
+public:
+    static constexpr size_t SLAB_SIZE = 256;
+
+    static void* allocate( size_t size ){
+        if( size != sizeof(T) ) return ::operator new( size );
+        Cache& cache = localCache;
+        if( cache.head == nullptr ) refill( cache );
+        Node* node = cache.head;
+        cache.head = node->next;
+        cache.count -= 1;
+        return node;
+    }
+
+    static void deallocate( void* p, size_t size ){
+        if( p == nullptr ) return;
+        if( size != sizeof(T) ){
+            ::operator delete( p );
+            return;
+        }
+        Cache& cache = localCache;
+        Node* node = static_cast<Node*>( p );
+        node->next = cache.head;
+        cache.head = node;
+        cache.count += 1;
+        if( cache.count > 2 * SLAB_SIZE ) spill( cache, SLAB_SIZE );
+    }
+    
+    /// Number of slabs allocated so far
+    static size_t slabCount(){
+        std::lock_guard<std::mutex> lock( shared.mutex );
+        return shared.nSlabs;
+    }
+
+private:
+    union Node {
+        Node* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+    
+    // Free objects of one thread; returned to the shared list when the
+    // thread exits
+    struct Cache {
+        Node* head = nullptr;
+        size_t count = 0;
+        ~Cache(){ if( count > 0 ) spill( *this, count ); }
+    };
+    // Free objects available to all threads
+    struct Shared {
+        std::mutex mutex;
+        Node* head = nullptr;
+        size_t count = 0;
+        size_t nSlabs = 0;
+    };
+    
+    // Fill an empty cache from the shared list, or else from a new slab
+    static void refill( Cache& cache ){
+        {
+            std::lock_guard<std::mutex> lock( shared.mutex );
+            if( shared.head != nullptr ){
+                const size_t n = std::min( shared.count, SLAB_SIZE );
+                cache.head = shared.head;
+                Node* last = shared.head;
+                for( size_t i = 1; i < n; ++i ) last = last->next;
+                shared.head = last->next;
+                shared.count -= n;
+                last->next = nullptr;
+                cache.count = n;
+                return;
+            }
+            shared.nSlabs += 1;
+        }
+        Node* slab = static_cast<Node*>( ::operator new( SLAB_SIZE * sizeof(Node) ) );
+        for( size_t i = SLAB_SIZE; i > 0; --i ){     // hand out in address order
+            slab[i-1].next = cache.head;
+            cache.head = &slab[i-1];
+        }
+        cache.count = SLAB_SIZE;
+    }
+    
+    // Move the first n objects of a cache to the shared list
+    static void spill( Cache& cache, size_t n ){
+        Node* first = cache.head;
+        Node* last = first;
+        for( size_t i = 1; i < n; ++i ) last = last->next;
+        cache.head = last->next;
+        cache.count -= n;
+        
+        std::lock_guard<std::mutex> lock( shared.mutex );
+        last->next = shared.head;
+        shared.head = first;
+        shared.count += n;
+    }
+
+    static thread_local Cache localCache;
+    static Shared shared;
+};
+
+template<class T>
+thread_local typename ObjectPool<T>::Cache ObjectPool<T>::localCache;
+template<class T>
+typename ObjectPool<T>::Shared ObjectPool<T>::shared;
+
+/// Base class giving T class-specific operator new/delete using ObjectPool<T>
+template<class T>
+class Pooled {
+public:
+    static void* operator new( size_t size ){
+        return ObjectPool<T>::allocate( size );
+    }
+    static void operator delete( void* p, size_t size ){
+        ObjectPool<T>::deallocate( p, size );
+    }
+};
+
+} }
+#endif
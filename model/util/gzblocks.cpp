@@ -0,0 +1,206 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2025 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2025 University of Basel
+ * Copyright (C) 2025 The Kids Research Institute Australia
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#include "util/gzblocks.h"
+#include "util/errors.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <zlib.h>
+
+namespace OM { namespace util { namespace gzblocks {
+
+namespace {
+    // Member header: gzip ID, CM=deflate, FLG=FEXTRA, MTIME=0, XFL=0,
+    // OS=unknown, XLEN=8, then subfield "OM" of length 4 holding the member size
+    const size_t HEADER_SIZE = 20;
+    const unsigned char HEADER[HEADER_SIZE - 4] = {
+        0x1f, 0x8b, 8, 4, 0, 0, 0, 0, 0, 255, 8, 0, 'O', 'M', 4, 0
+    };
+    const size_t TRAILER_SIZE = 8;      // CRC32, ISIZE
+
+    void putUint32( unsigned char* p, uint32_t x ){
+        for( int i = 0; i < 4; ++i ) p[i] = static_cast<unsigned char>( x >> (8 * i) );
+    }
+    uint32_t getUint32( const unsigned char* p ){
+        return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+    }
+
+    /* Call f(i) for each i in [0, n), spreading the work over the available
+     * cores. Independent of util::parallel: this may run on a background
+     * thread while the simulation uses the worker pool. If f throws, the
+     * first exception (by thread) is rethrown. */
+    void forEachBlock( size_t n, const std::function<void(size_t)>& f ){
+        const size_t nThreads = std::min<size_t>( n, std::max( 1u, std::thread::hardware_concurrency() ) );
+        std::vector<std::exception_ptr> errors( nThreads );
+        auto work = [&]( size_t t ){
+            try{
+                for( size_t i = t; i < n; i += nThreads ) f( i );
+            }catch( ... ){
+                errors[t] = std::current_exception();
+            }
+        };
+        std::vector<std::thread> threads;
+        for( size_t t = 1; t < nThreads; ++t ) threads.emplace_back( work, t );
+        if( nThreads > 0 ) work( 0 );
+        for( std::thread& thread : threads ) thread.join();
+        for( const std::exception_ptr& e : errors ){
+            if( e ) std::rethrow_exception( e );
+        }
+    }
+
+    /// Compress len bytes at in as one gzip member
+    std::string compressBlock( const char* in, size_t len ){
+        z_stream z = z_stream();
+        if( deflateInit2( &z, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY ) != Z_OK )
+            throw checkpoint_error( "gzip: deflateInit failed" );
+        std::string out( HEADER_SIZE + deflateBound( &z, len ) + TRAILER_SIZE, '\0' );
+        unsigned char* p = reinterpret_cast<unsigned char*>( &out[0] );
+        z.next_in = reinterpret_cast<Bytef*>( const_cast<char*>( in ) );
+        z.avail_in = len;
+        z.next_out = p + HEADER_SIZE;
+        z.avail_out = out.size() - HEADER_SIZE - TRAILER_SIZE;
+        const int ret = deflate( &z, Z_FINISH );
+        const size_t deflated = z.total_out;
+        deflateEnd( &z );
+        if( ret != Z_STREAM_END )
+            throw checkpoint_error( "gzip: deflate failed" );
+
+        const size_t size = HEADER_SIZE + deflated + TRAILER_SIZE;
+        std::copy( HEADER, HEADER + HEADER_SIZE - 4, p );
+        putUint32( p + HEADER_SIZE - 4, size );
+        putUint32( p + HEADER_SIZE + deflated,
+                crc32( 0, reinterpret_cast<const Bytef*>( in ), len ) );
+        putUint32( p + HEADER_SIZE + deflated + 4, len );
+        out.resize( size );
+        return out;
+    }
+
+    /// Inflate one member written by compressBlock into out[0, len)
+    void decompressBlock( const unsigned char* in, size_t size, char* out, size_t len ){
+        z_stream z = z_stream();
+        if( inflateInit2( &z, -MAX_WBITS ) != Z_OK )
+            throw checkpoint_error( "gzip: inflateInit failed" );
+        z.next_in = const_cast<Bytef*>( in + HEADER_SIZE );
+        z.avail_in = size - HEADER_SIZE - TRAILER_SIZE;
+        z.next_out = reinterpret_cast<Bytef*>( out );
+        z.avail_out = len;
+        const int ret = inflate( &z, Z_FINISH );
+        const bool complete = ret == Z_STREAM_END && z.avail_in == 0 && z.avail_out == 0;
+        inflateEnd( &z );
+        if( !complete ||
+            crc32( 0, reinterpret_cast<const Bytef*>( out ), len ) != getUint32( in + size - TRAILER_SIZE ) )
+            throw checkpoint_error( "gzip: corrupt block" );
+    }
+
+    /// True if the member at p (with n bytes remaining) has our header
+    bool isBlock( const unsigned char* p, size_t n ){
+        return n >= HEADER_SIZE + TRAILER_SIZE &&
+            std::equal( HEADER, HEADER + HEADER_SIZE - 4, p ) &&
+            getUint32( p + HEADER_SIZE - 4 ) >= HEADER_SIZE + TRAILER_SIZE &&
+            getUint32( p + HEADER_SIZE - 4 ) <= n;
+    }
+
+    /// Inflate any gzip data (possibly several members) on this thread
+    std::string decompressAll( const std::string& in ){
+        z_stream z = z_stream();
+        if( inflateInit2( &z, 16 + MAX_WBITS ) != Z_OK )
+            throw checkpoint_error( "gzip: inflateInit failed" );
+        z.next_in = reinterpret_cast<Bytef*>( const_cast<char*>( in.data() ) );
+        z.avail_in = in.size();
+        std::string out;
+        std::vector<char> buf( BLOCK_SIZE );
+        int ret;
+        do{
+            z.next_out = reinterpret_cast<Bytef*>( buf.data() );
+            z.avail_out = buf.size();
+            ret = inflate( &z, Z_NO_FLUSH );
+            out.append( buf.data(), buf.size() - z.avail_out );
+            if( ret == Z_STREAM_END && z.avail_in > 0 ){
+                inflateReset( &z );     // next member
+                ret = Z_OK;
+            }
+        }while( ret == Z_OK );
+        inflateEnd( &z );
+        if( ret != Z_STREAM_END )
+            throw checkpoint_error( "gzip: corrupt or truncated data" );
+        return out;
+    }
+}
+
+void writeFile( const std::string& fileName, const std::string& data ){
+    const size_t nBlocks = std::max<size_t>( 1, (data.size() + BLOCK_SIZE - 1) / BLOCK_SIZE );
+    std::vector<std::string> blocks( nBlocks );
+    forEachBlock( nBlocks, [&]( size_t i ){
+        const size_t start = i * BLOCK_SIZE;
+        blocks[i] = compressBlock( data.data() + start, std::min( BLOCK_SIZE, data.size() - start ) );
+    } );
+
+    std::ofstream out( fileName, std::ios::out | std::ios::binary );
+    for( const std::string& block : blocks ) out.write( block.data(), block.size() );
+    out.close();
+    if( out.fail() )
+        throw checkpoint_error( "error writing to file \"" + fileName + "\"" );
+}
+
+std::string readFile( const std::string& fileName ){
+    std::ifstream file( fileName, std::ios::in | std::ios::binary | std::ios::ate );
+    const std::streamoff fileSize = file.tellg();
+    if( !file.is_open() || fileSize <= 0 )
+        throw checkpoint_error( "Unable to read file \"" + fileName + "\"" );
+    std::string in( fileSize, '\0' );
+    file.seekg( 0 );
+    file.read( &in[0], fileSize );
+    if( !file )
+        throw checkpoint_error( "Unable to read file \"" + fileName + "\"" );
+
+    // Find the members and their offsets in the output
+    const unsigned char* p = reinterpret_cast<const unsigned char*>( in.data() );
+    std::vector<size_t> inPos, outPos;
+    size_t pos = 0, outSize = 0;
+    while( pos < in.size() ){
+        if( !isBlock( p + pos, in.size() - pos ) ){
+            if( pos == 0 ) return decompressAll( in );  // some other gzip file
+            throw checkpoint_error( "gzip: corrupt block header in \"" + fileName + "\"" );
+        }
+        inPos.push_back( pos );
+        outPos.push_back( outSize );
+        pos += getUint32( p + pos + HEADER_SIZE - 4 );
+        outSize += getUint32( p + pos - 4 );
+    }
+    inPos.push_back( pos );
+    outPos.push_back( outSize );
+
+    std::string out( outSize, '\0' );
+    forEachBlock( inPos.size() - 1, [&]( size_t i ){
+        decompressBlock( p + inPos[i], inPos[i+1] - inPos[i], &out[0] + outPos[i], outPos[i+1] - outPos[i] );
+    } );
+    return out;
+}
+
+} } }
@@ -0,0 +1,60 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2025 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2025 University of Basel
+ * Copyright (C) 2025 The Kids Research Institute Australia
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef Hmod_util_gzblocks
+#define Hmod_util_gzblocks
+
+/* Gzip compression of whole buffers in independent blocks, used for
+ * checkpoint files.
+ *
+ * Data is split into blocks of BLOCK_SIZE bytes, each compressed as a
+ * separate gzip member; a multi-member file is still a valid gzip file (and
+ * decompresses to the concatenated data with gunzip or zcat). Each member
+ * records its compressed size in an extra header field (subfield "OM", like
+ * BGZF's "BC"), so that the reader can find all members without
+ * decompressing and inflate them in parallel too. */
+
+#include <cstddef>
+#include <string>
+
+namespace OM { namespace util { namespace gzblocks {
+
+/// Uncompressed size of each block (except the last)
+const size_t BLOCK_SIZE = 1 << 20;
+
+/** Compress data and write it to fileName, replacing any existing file.
+ * Blocks are compressed in parallel.
+ *
+ * @throws checkpoint_error on write error */
+void writeFile( const std::string& fileName, const std::string& data );
+
+/** Read and decompress a file written by writeFile, in parallel.
+ *
+ * Other gzip files (such as checkpoints written by earlier versions) are
+ * also accepted, but decompressed on a single thread.
+ *
+ * @throws checkpoint_error if the file cannot be read or is not valid */
+std::string readFile( const std::string& fileName );
+
+} } }
+#endif
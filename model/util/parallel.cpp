@@ -0,0 +1,169 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2025 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2025 University of Basel
+ * Copyright (C) 2025 The Kids Research Institute Australia
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "util/parallel.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace OM { namespace util { namespace parallel {
+
+namespace {
+    thread_local size_t currentChunk = SERIAL;
+
+    // All live journals. Function-local so that it outlives static journals.
+    std::vector<Mergeable*>& registry(){
+        static std::vector<Mergeable*> mergeables;
+        return mergeables;
+    }
+
+    /* Workers 1..n-1 each wait for a new generation, run their chunk of the
+     * current task, then decrement `pending`. */
+    class Pool {
+    public:
+        ~Pool(){ stop(); }
+
+        void start( size_t nThreads ){
+            assert( workers.empty() );
+            for( size_t c = 1; c < nThreads; ++c ){
+                workers.emplace_back( &Pool::workerMain, this, c );
+            }
+        }
+
+        void stop(){
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                stopping = true;
+            }
+            cvStart.notify_all();
+            for( std::thread& t : workers ) t.join();
+            workers.clear();
+        }
+
+        /// Run task(c) for c in [0, nThreads), chunk 0 on this thread
+        void run( const std::function<void(size_t)>& task ){
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                current = &task;
+                pending = workers.size();
+                generation += 1;
+            }
+            cvStart.notify_all();
+            task( 0 );
+            std::unique_lock<std::mutex> lock( mutex );
+            cvDone.wait( lock, [this]{ return pending == 0; } );
+            current = nullptr;
+        }
+
+    private:
+        void workerMain( size_t c ){
+            uint64_t seen = 0;
+            std::unique_lock<std::mutex> lock( mutex );
+            while( true ){
+                cvStart.wait( lock, [&]{ return stopping || generation != seen; } );
+                if( stopping ) return;
+                seen = generation;
+                const std::function<void(size_t)>& task = *current;
+                lock.unlock();
+                task( c );
+                lock.lock();
+                if( --pending == 0 ) cvDone.notify_one();
+            }
+        }
+
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable cvStart, cvDone;
+        const std::function<void(size_t)> *current = nullptr;
+        uint64_t generation = 0;
+        size_t pending = 0;
+        bool stopping = false;
+    } pool;
+
+    size_t nThreads = 1;
+}
+
+void init( size_t n ){
+    if( n == 0 ) n = std::max<size_t>( 1, std::thread::hardware_concurrency() );
+    nThreads = n;
+    pool.start( nThreads );
+}
+
+size_t numThreads(){
+    return nThreads;
+}
+
+size_t chunk(){
+    return currentChunk;
+}
+
+void forEach( size_t n, const std::function<void(size_t)>& body ){
+    assert( currentChunk == SERIAL );   // no nesting
+    if( nThreads == 1 || n < nThreads ){
+        for( size_t i = 0; i < n; ++i ) body( i );
+        return;
+    }
+
+    for( Mergeable* m : registry() ) m->prepare( nThreads );
+
+    std::vector<std::exception_ptr> errors( nThreads );
+    std::vector<int> errnos( nThreads, 0 );
+    pool.run( [&]( size_t c ){
+        currentChunk = c;
+        errno = 0;
+        try{
+            for( size_t i = n * c / nThreads, end = n * (c + 1) / nThreads; i < end; ++i ){
+                body( i );
+            }
+        }catch( ... ){
+            errors[c] = std::current_exception();
+        }
+        errnos[c] = errno;
+        currentChunk = SERIAL;
+    } );
+
+    for( Mergeable* m : registry() ) m->merge();
+
+    // errno is per-thread; pass on the first error so main() can report it
+    for( int e : errnos ){
+        if( e != 0 ){ errno = e; break; }
+    }
+    for( const std::exception_ptr& e : errors ){
+        if( e ) std::rethrow_exception( e );
+    }
+}
+
+Mergeable::Mergeable(){
+    registry().push_back( this );
+}
+Mergeable::~Mergeable(){
+    std::vector<Mergeable*>& r = registry();
+    r.erase( std::remove( r.begin(), r.end(), this ), r.end() );
+}
+
+} } }
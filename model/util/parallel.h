@@ -0,0 +1,124 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2025 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2025 University of Basel
+ * Copyright (C) 2025 The Kids Research Institute Australia
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef Hmod_util_parallel
+#define Hmod_util_parallel
+
+/* This module provides the worker pool used to update humans in parallel.
+ *
+ * Parallel sections split an index range into one contiguous chunk per
+ * thread; the calling thread processes chunk 0. Anything shared between
+ * humans which is order-sensitive (notably sums of doubles) must not be
+ * written directly from a parallel section: instead record the operation in a
+ * Journal. When all chunks are complete, journals are replayed on the calling
+ * thread in chunk order, which is exactly the order of a serial loop. Results
+ * are thus identical whatever the number of threads.
+ */
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace OM { namespace util { namespace parallel {
+
+/// Value of chunk() outside of parallel sections
+const size_t SERIAL = std::numeric_limits<size_t>::max();
+
+/** Set the number of threads used by parallel sections (including the
+ * calling thread). 1 (the default) disables threading. Call once, before
+ * the simulation starts. */
+void init( size_t nThreads );
+
+/// Number of threads used by parallel sections
+size_t numThreads();
+
+/// Chunk being processed by the calling thread, or SERIAL.
+size_t chunk();
+
+/// True when called from within a parallel section
+inline bool isParallel(){ return chunk() != SERIAL; }
+
+/** Call body(i) for each i in [0, n).
+ *
+ * The range is split into numThreads() contiguous chunks; each chunk is
+ * processed in increasing order by a single thread. All journals are merged
+ * before returning. If body throws, the exception from the lowest chunk is
+ * rethrown (after merging). */
+void forEach( size_t n, const std::function<void(size_t)>& body );
+
+/// Base class of deferred operations; registers itself for merging.
+class Mergeable {
+public:
+    Mergeable();
+    virtual ~Mergeable();
+
+    Mergeable(const Mergeable&) = delete;
+    Mergeable& operator=(const Mergeable&) = delete;
+
+    /// Make sure there is space for nChunks (called before work starts)
+    virtual void prepare( size_t nChunks ) = 0;
+    /// Apply deferred operations in chunk order (called after work finishes)
+    virtual void merge() = 0;
+};
+
+/** A list of operations recorded per chunk and applied in chunk order.
+ *
+ * T is the recorded item; apply is called on each item when merging (and
+ * directly by record() outside of parallel sections). */
+template<class T>
+class Journal : public Mergeable {
+public:
+    explicit Journal( std::function<void(const T&)> apply ) :
+        apply(std::move(apply)) {}
+
+    /** If in a parallel section, save x for later and return true.
+     * Otherwise do nothing and return false (caller should apply directly). */
+    inline bool defer( const T& x ){
+        size_t c = chunk();
+        if( c == SERIAL ) return false;
+        logs[c].push_back( x );
+        return true;
+    }
+
+    /// Apply x now or, in a parallel section, when merging.
+    inline void record( const T& x ){
+        if( !defer( x ) ) apply( x );
+    }
+
+    virtual void prepare( size_t nChunks ){
+        if( logs.size() < nChunks ) logs.resize( nChunks );
+    }
+    virtual void merge(){
+        for( std::vector<T>& log : logs ){
+            for( const T& x : log ) apply( x );
+            log.clear();        // keeps capacity for the next step
+        }
+    }
+
+private:
+    std::function<void(const T&)> apply;
+    std::vector<std::vector<T>> logs;
+};
+
+} } }
+#endif
@@ -65,18 +65,21 @@ double sample_double01 (void *ptr) {
     return rng->gen_double();
 }
 
+/// GSL adaptor type for generator T: one static instance per generator type
 template<class T>
-gsl_rng_type make_gsl_rng_type(T& rng) {
-    return {
-        "OM_RNG",		// name
-        std::numeric_limits<uint32_t>::max(),
-        std::numeric_limits<uint32_t>::min(),
-        0,				// size of state; not used here
-        nullptr,			// re-seed function; don't use
-        &sample_ulong<T>,
-        &sample_double01<T>
-    };
-}
+struct GslRngType {
+    static const gsl_rng_type type;
+};
+template<class T>
+const gsl_rng_type GslRngType<T>::type = {
+    "OM_RNG",		// name
+    std::numeric_limits<uint32_t>::max(),
+    std::numeric_limits<uint32_t>::min(),
+    0,				// size of state; not used here
+    nullptr,			// re-seed function; don't use
+    &sample_ulong<T>,
+    &sample_double01<T>
+};
 
 /// Our random number generator.
 template<class T>
@@ -89,38 +92,19 @@ struct RNG {
     /// seeding with only a 64-bit seed. Since many instances of the LocalRng
     /// are used, 128-bit seeds are recommended to reduce chance of overlapping
     /// sections of RNG output.
-    explicit RNG(uint64_t seed, uint64_t stream): m_rng(seed, stream) {
-        m_gsl_type = make_gsl_rng_type(m_rng);
-        m_gsl_gen.type = &m_gsl_type;
-        m_gsl_gen.state = reinterpret_cast<void*>(&m_rng);
-    }
+    explicit RNG(uint64_t seed, uint64_t stream): m_rng(seed, stream) {}
     
     /// Seed via another RNG
     template<class S>
-    explicit RNG(RNG<S>& source): m_rng(source.m_rng) {
-        m_gsl_type = make_gsl_rng_type(m_rng);
-        m_gsl_gen.type = &m_gsl_type;
-        m_gsl_gen.state = reinterpret_cast<void*>(&m_rng);
-    }
+    explicit RNG(RNG<S>& source): m_rng(source.m_rng) {}
     
     // Disable copying
     RNG(const RNG&) = delete;
     RNG& operator=(const RNG&) = delete;
   
-    /// Allow moving, with explicit functions
-    RNG(RNG&& other): m_rng(std::move(other.m_rng)) {
-        m_gsl_type = other.m_gsl_type;
-        // The following point into instance of this RNG:
-        m_gsl_gen.type = &m_gsl_type;
-        m_gsl_gen.state = reinterpret_cast<void*>(&m_rng);
-    }
-    void operator=(RNG&& other) {
-        m_rng = std::move(other.m_rng);
-        m_gsl_type = other.m_gsl_type;
-        // The following point into instance of this RNG:
-        m_gsl_gen.type = &m_gsl_type;
-        m_gsl_gen.state = reinterpret_cast<void*>(&m_rng);
-    }
+    /// Allow moving
+    RNG(RNG&& other) = default;
+    RNG& operator=(RNG&& other) = default;
     
     /// Seed with given 128-bit input (see notes on constructor)
     void seed(uint64_t seed, uint64_t stream) {
@@ -152,12 +136,12 @@ struct RNG {
     /** This function returns a Gaussian random variate, with mean mean and
      * standard deviation std. The sampled value x ~ N(mean, std^2) . */
     double gauss (double mean, double std){
-        return gsl_ran_gaussian(&m_gsl_gen,std)+mean;
+        return gsl_ran_gaussian(gsl_view().get(),std)+mean;
     }
     
     /** This function returns a random variate from the gamma distribution. */
     double gamma (double a, double b){
-        return gsl_ran_gamma(&m_gsl_gen, a, b);
+        return gsl_ran_gamma(gsl_view().get(), a, b);
     }
     
     /** This function returns a random variate from the lognormal distribution.
@@ -169,7 +153,7 @@ struct RNG {
      * @param sigma sigma-log
      */
     double log_normal (double meanlog, double stdlog){
-        return gsl_ran_lognormal (&m_gsl_gen, meanlog, stdlog);
+        return gsl_ran_lognormal (gsl_view().get(), meanlog, stdlog);
     }
     
     /** Return the maximum over multiple log-normal samples.
@@ -196,7 +180,7 @@ struct RNG {
     
     /** This function returns a random variate from the beta distribution. */
     double beta(double a, double b){
-        return gsl_ran_beta (&m_gsl_gen,a,b);
+        return gsl_ran_beta (gsl_view().get(),a,b);
     }
     
     /** This function wraps beta(), setting b=b and a such that m is the mean
@@ -213,7 +197,7 @@ struct RNG {
             //This would lead to an inifinite loop
             throw TRACED_EXCEPTION( "lambda is inf", Error::InfLambda );
         }
-        return gsl_ran_poisson (&m_gsl_gen, lambda);
+        return gsl_ran_poisson (gsl_view().get(), lambda);
     }
 
     /** This function returns true with probability prob or 0 with probability
@@ -240,16 +224,23 @@ struct RNG {
      * @param k is the shape parameter
      */
     double weibull( double lambda, double k ){
-        return gsl_ran_weibull( &m_gsl_gen, lambda, k );
+        return gsl_ran_weibull( gsl_view().get(), lambda, k );
     }
     //@}
     
 private:
-    T m_rng;
+    /* A gsl_rng using this generator, for GSL's distributions. This is only a
+     * view (a type pointer and a state pointer), made for each call, so that
+     * an RNG holds nothing but the generator state. */
+    struct GslView {
+        gsl_rng gen;
+        gsl_rng* get() { return &gen; }
+    };
+    inline GslView gsl_view() {
+        return GslView{ gsl_rng{ &GslRngType<T>::type, reinterpret_cast<void*>(&m_rng) } };
+    }
     
-    // Hooks for GSL distributions
-    gsl_rng_type m_gsl_type;
-    gsl_rng m_gsl_gen;
+    T m_rng;
     
     template<class> friend class RNG;
 };
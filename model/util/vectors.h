@@ -27,6 +27,8 @@
 #include "util/errors.h"
 #include "util/checkpoint_containers.h"
 
+#include <complex>
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -68,6 +70,25 @@ namespace vectors {
       x[i] += y[i];
     }
   }
+  
+  /** Remove all elements for which remove(element) returns true, keeping
+   * the order of the other elements.
+   * 
+   * Unlike std::remove_if, remove is called exactly once for each element, in
+   * order, so it may depend on which earlier elements were kept. Each kept
+   * element is moved at most once, so this takes linear time (repeated calls
+   * to erase take quadratic time). Removed elements are destroyed before
+   * returning. */
+  template<class T, class Pred>
+  void compact (vector<T>& vec, Pred remove){
+    auto out = vec.begin();
+    for( auto it = vec.begin(); it != vec.end(); ++it ){
+      if( remove(*it) ) continue;
+      if( out != it ) *out = std::move(*it);
+      ++out;
+    }
+    vec.erase( out, vec.end() );
+  }
   //@}
   
   
@@ -176,6 +197,62 @@ namespace vectors {
         tArray[t] = exp(temp);
     }
   }
+  
+  /** Discrete Fourier transform of x, in place, for any length of x.
+   * 
+   * Computes X[m] = Σ_t x[t]·exp(sign·2πi·m·t/n) (unscaled; use sign -1 for
+   * the forward and +1 for the inverse transform). Uses mixed-radix
+   * Cooley-Tukey decimation, so the cost is O(n·Σp) over prime factors p of
+   * n (O(n log n) when n is smooth, O(n²) when n is prime). */
+  inline void fft(vector<complex<double>>& x, int sign) {
+    const size_t n = x.size();
+    if (n <= 1) return;
+    size_t p = 2;       // smallest prime factor of n
+    while (n % p != 0 && p * p <= n) ++p;
+    if (n % p != 0) p = n;
+    const size_t m = n / p;
+    
+    // Transform each of the p decimated sub-sequences x[r + p·j] into
+    // sub[r·m + j]
+    vector<complex<double>> sub(n), part(m);
+    for (size_t r = 0; r < p; ++r) {
+        for (size_t j = 0; j < m; ++j) part[j] = x[r + p * j];
+        fft(part, sign);
+        std::copy(part.begin(), part.end(), sub.begin() + r * m);
+    }
+    
+    // Combine: X[k] = Σ_r W[r·k mod n]·sub[r·m + k mod m], W[j] = exp(sign·2πi·j/n)
+    vector<complex<double>> W(n);
+    for (size_t j = 0; j < n; ++j) W[j] = std::polar(1.0, sign * 2.0 * M_PI * j / n);
+    for (size_t k = 0; k < n; ++k) {
+        const size_t km = k % m;
+        complex<double> sum = sub[km];
+        for (size_t r = 1, j = k; r < p; ++r) {
+            // written out: operator* checks for inf/NaN, which is slow
+            const complex<double> &a = W[j], &b = sub[r * m + km];
+            sum += complex<double>(a.real() * b.real() - a.imag() * b.imag(),
+                                   a.real() * b.imag() + a.imag() * b.real());
+            j += k;     // j = r·k mod n
+            if (j >= n) j -= n;
+        }
+        x[k] = sum;
+    }
+  }
+  
+  /** Circular cross-correlation of two real series of equal length n:
+   * corr[k] = Σ_t a[(t-k) mod n]·b[t], for k in [0, n), computed via fft. */
+  inline void circularCrossCorrelation(const vector<double>& a, const vector<double>& b, vector<double>& corr) {
+    if (a.size() != b.size())
+        throw TRACED_EXCEPTION_DEFAULT("circularCrossCorrelation: series must have equal length");
+    const size_t n = a.size();
+    vector<complex<double>> A(a.begin(), a.end()), B(b.begin(), b.end());
+    fft(A, -1);
+    fft(B, -1);
+    for (size_t m = 0; m < n; ++m) A[m] = std::conj(A[m]) * B[m];
+    fft(A, +1);
+    corr.resize(n);
+    for (size_t k = 0; k < n; ++k) corr[k] = A[k].real() / n;
+  }
 }
 
 /// Utility to print a vector (operator must be in namespace)
@@ -39,6 +39,7 @@ import gzip
 sys.path[0]="@CMAKE_SOURCE_DIR@/util"
 import compareOutput
 import compareCtsout
+import readOutput
 import xml.sax.handler
 
 class RunError(Exception):
@@ -146,6 +147,7 @@ def runScenario(options,omOptions,name):
     simDir = tempfile.mkdtemp(prefix=tmpprefix+'-', dir=testBuildDir)
     outputFile=os.path.join(simDir,"output.txt")
     outputGzFile=os.path.join(simDir,"output.txt.gz")
+    outputBinFile=os.path.join(simDir,"output.bin")
     ctsoutFile=os.path.join(simDir,"ctsout.txt")
     ctsoutGzFile=os.path.join(simDir,"ctsout.txt.gz")
     checkFile=os.path.join(simDir,"checkpoint")
@@ -180,6 +182,11 @@ def runScenario(options,omOptions,name):
             f_in.close()
             os.remove(outputGzFile)
         
+        # check for output.bin (--binary-output) and convert to text:
+        if (os.path.isfile(outputBinFile)) and (not os.path.isfile(outputFile)):
+            readOutput.binaryToText(outputBinFile, outputFile)
+            os.remove(outputBinFile)
+        
         # check for ctsout.txt.gz in place of ctsout.txt and uncompress:
         if (os.path.isfile(ctsoutGzFile)) and (not os.path.isfile(ctsoutFile)):
             f_in = gzip.open(ctsoutGzFile, 'rb')
@@ -75,6 +75,31 @@ public:
         }
     }
     
+    void testTabulated () {
+        for( const char* interp : { "none", "linear" } ){
+            agvElt->setInterpolation( interp );
+            AgeGroupInterpolator o, t;
+            o.set( *agvElt, "testTabulated" );
+            t.set( *agvElt, "testTabulated" );
+            t.tabulate();
+            // identical on the time-step grid (ages at ts0/ts1)
+            for( SimTime age = sim::zero(); age <= sim::maxHumanAge() + sim::oneYear(); age = age + sim::oneTS() ){
+                TS_ASSERT_EQUALS( t.eval( sim::inYears(age) ), o.eval( sim::inYears(age) ) );
+            }
+            // other ages use the interpolation directly
+            for( size_t i = 0; i < testLen; ++i ){
+                TS_ASSERT_EQUALS( t.eval( testAges[ i ] ), o.eval( testAges[ i ] ) );
+                TS_ASSERT_EQUALS( t.eval( testAges[ i ] + 0.001 ), o.eval( testAges[ i ] + 0.001 ) );
+            }
+            // the table follows scaling
+            o.scale( 1.7 );
+            t.scale( 1.7 );
+            for( SimTime age = sim::zero(); age <= sim::maxHumanAge(); age = age + sim::oneTS() ){
+                TS_ASSERT_EQUALS( t.eval( sim::inYears(age) ), o.eval( sim::inYears(age) ) );
+            }
+        }
+    }
+    
 private:
     static const size_t dataLen = 5;
     static const size_t testLen = 8;
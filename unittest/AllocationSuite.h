@@ -0,0 +1,268 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2025 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2025 University of Basel
+ * Copyright (C) 2025 The Kids Research Institute Australia
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef Hmod_AllocationSuite
+#define Hmod_AllocationSuite
+
+#include <cxxtest/TestSuite.h>
+#include "UnittestUtil.h"
+#include "Host/WithinHost/DescriptiveWithinHost.h"
+#include "util/vectors.h"
+#include "util/ObjectPool.h"
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <sstream>
+#include <thread>
+
+using namespace OM::WithinHost;
+
+/* Replacement global operator new/delete counting allocations while enabled.
+ * This header is only included by the generated test runner, so these are
+ * defined exactly once in the test program. */
+namespace AllocationCounter {
+    bool enabled = false;
+    size_t count = 0;
+}
+void* operator new( std::size_t size ){
+    if( AllocationCounter::enabled ) ++AllocationCounter::count;
+    void *p = std::malloc( size == 0 ? 1 : size );
+    if( p == nullptr ) throw std::bad_alloc();
+    return p;
+}
+void operator delete( void *p ) noexcept { std::free( p ); }
+void operator delete( void *p, std::size_t ) noexcept { std::free( p ); }
+
+/** The per-human transmission code runs every step for every human and
+ * should not allocate once scratch space has been set up.
+ * 
+ * Only the within-host part is counted: writing lagged densities (as at the
+ * end of the within-host update()) and probTransmissionToMosquito.
+ * TransmissionModel::getEIR and the rest of WHInterface::update need a
+ * fully initialised Human and transmission model and are not covered; new
+ * infections, drugs and episodes allocate anyway. */
+class AllocationSuite : public CxxTest::TestSuite
+{
+public:
+    void setUp () {
+        UnittestUtil::initTime(1);
+        oldYLagLen = WHFalciparum::y_lag_len;
+        WHFalciparum::y_lag_len = sim::inSteps(sim::fromDays(20)) + 1;
+
+        LocalRng rng(0, 721347520444481703);
+        wh = new DescriptiveWithinHostModel{ rng, numeric_limits<double>::quiet_NaN() };
+        // an infectious human: parasites of all genotypes present over the
+        // last 20 days
+        for( uint32_t slot = 0; slot < uint32_t(WHFalciparum::y_lag_len); ++slot ){
+            for( uint32_t g = 0; g < Genotypes::N(); ++g ){
+                wh->m_y_lag.push_back( LagDensity{ slot, g, 5000.0, 20000.0 } );
+            }
+        }
+    }
+    void tearDown () {
+        delete wh;
+        WHFalciparum::y_lag_len = oldYLagLen;
+    }
+
+    void testProbTransmissionToMosquito () {
+        vector<GenotypeTransmission> probTrans;
+        // first call may allocate per-thread scratch space
+        const double pTransmit = wh->probTransmissionToMosquito( probTrans );
+        TS_ASSERT_LESS_THAN( 0.0, pTransmit );
+
+        AllocationCounter::count = 0;
+        AllocationCounter::enabled = true;
+        double p = 0.0;
+        for( int i = 0; i < 100; ++i ){
+            // a new step each time, so that the value is calculated (not cached)
+            UnittestUtil::incrTime( sim::oneTS() );
+            p = wh->probTransmissionToMosquito( probTrans );
+        }
+        AllocationCounter::enabled = false;
+
+        TS_ASSERT_EQUALS( AllocationCounter::count, 0u );
+        TS_ASSERT_EQUALS( wh->m_pTransmitTime, sim::ts1() );
+        TS_ASSERT_EQUALS( p, pTransmit );
+        TS_ASSERT_EQUALS( probTrans.size(), size_t(Genotypes::N()) );
+        double sum = 0.0;
+        for( const GenotypeTransmission& trans : probTrans ) sum += trans.prob_i + trans.prob_l;
+        TS_ASSERT_APPROX( sum, pTransmit );
+    }
+
+    // Compare probTransmissionToMosquito (cached) with an uncached calculation
+    void checkCachedProbTransmission( double expected ){
+        vector<GenotypeTransmission> probTrans;
+        TS_ASSERT_EQUALS( wh->probTransmissionToMosquito( probTrans ), expected );
+        TS_ASSERT_EQUALS( wh->m_pTransmitTime, sim::ts1() );
+        const vector<GenotypeTransmission> cached = probTrans;
+        TS_ASSERT_EQUALS( wh->calcProbTransmissionToMosquito(), expected );
+        TS_ASSERT_EQUALS( cached.size(), wh->m_pTransmitGenotype.size() );
+        for( size_t i = 0; i < cached.size() && i < wh->m_pTransmitGenotype.size(); ++i ){
+            TS_ASSERT_EQUALS( cached[i].genotype, wh->m_pTransmitGenotype[i].genotype );
+            TS_ASSERT_EQUALS( cached[i].prob_i, wh->m_pTransmitGenotype[i].prob_i );
+            TS_ASSERT_EQUALS( cached[i].prob_l, wh->m_pTransmitGenotype[i].prob_l );
+        }
+    }
+    
+    void testProbTransmissionCache () {
+        vector<GenotypeTransmission> probTrans;
+        const double p0 = wh->probTransmissionToMosquito( probTrans );
+        checkCachedProbTransmission( p0 );
+        
+        // update() writes densities for the step ending at ts1 (here: no
+        // infections); these are first used 10 days later
+        wh->setLagDensities( vector<DescriptiveInfection*>() );
+        checkCachedProbTransmission( p0 );
+        
+        // the cache is recalculated when the step changes
+        UnittestUtil::incrTime( sim::fromDays(10) );
+        const double p1 = wh->probTransmissionToMosquito( probTrans );
+        TS_ASSERT_LESS_THAN( p1, p0 );
+        checkCachedProbTransmission( p1 );
+        
+        // and reset when loading a checkpoint
+        stringstream stream;
+        wh->checkpoint( static_cast<ostream&>( stream ) );
+        wh->checkpoint( static_cast<istream&>( stream ) );
+        TS_ASSERT_EQUALS( wh->m_pTransmitTime, sim::never() );
+        checkCachedProbTransmission( p1 );
+    }
+
+    /// Stand-in for an infection, as read by WHFalciparum::setLagDensities
+    struct LagInfection {
+        uint32_t g;
+        InfectionOrigin o;
+        double density;
+        uint32_t genotype() const{ return g; }
+        InfectionOrigin origin() const{ return o; }
+        double getDensity() const{ return density; }
+    };
+    
+    void testSteadyStateStep () {
+        // a host with a stable set of infections: each step update() writes
+        // the step's densities, then vectorUpdate and updateKappa both ask
+        // for the probability of transmission
+        vector<LagInfection> infs = {
+            { 0, InfectionOrigin::Imported, 300.0 },
+            { 0, InfectionOrigin::Indigenous, 2000.0 },
+            { uint32_t(Genotypes::N() - 1), InfectionOrigin::Introduced, 800.0 }
+        };
+        vector<const LagInfection*> infections;
+        for( const LagInfection& inf : infs ) infections.push_back( &inf );
+        vector<GenotypeTransmission> probTransVector, probTransKappa;
+        // warm up: replace all lagged densities
+        for( int i = 0; i <= WHFalciparum::y_lag_len; ++i ){
+            UnittestUtil::incrTime( sim::oneTS() );
+            wh->setLagDensities( infections );
+            wh->probTransmissionToMosquito( probTransVector );
+            wh->probTransmissionToMosquito( probTransKappa );
+        }
+        
+        AllocationCounter::count = 0;
+        AllocationCounter::enabled = true;
+        double p = 0.0, pKappa = 0.0;
+        for( int i = 0; i < 100; ++i ){
+            UnittestUtil::incrTime( sim::oneTS() );
+            wh->setLagDensities( infections );
+            p = wh->probTransmissionToMosquito( probTransVector );
+            pKappa = wh->probTransmissionToMosquito( probTransKappa );
+        }
+        AllocationCounter::enabled = false;
+        
+        TS_ASSERT_EQUALS( AllocationCounter::count, 0u );
+        TS_ASSERT_LESS_THAN( 0.0, p );
+        TS_ASSERT_EQUALS( p, pKappa );
+        TS_ASSERT_EQUALS( probTransVector.size(), probTransKappa.size() );
+    }
+
+    void testUninfectedLagDensities () {
+        // per-human storage does not depend on the number of genotypes
+        LocalRng rng(0, 721347520444481703);
+        DescriptiveWithinHostModel uninfected{ rng, numeric_limits<double>::quiet_NaN() };
+        TS_ASSERT( uninfected.m_y_lag.empty() );
+        vector<GenotypeTransmission> probTrans( 3 );
+        TS_ASSERT_EQUALS( uninfected.probTransmissionToMosquito( probTrans ), 0.0 );
+        TS_ASSERT( probTrans.empty() );
+    }
+
+    struct PooledObject : public util::Pooled<PooledObject> {
+        virtual ~PooledObject() {}
+        double x[5];
+    };
+    struct LargerObject : public PooledObject {
+        double y[3];
+    };
+    
+    void testObjectPool () {
+        // objects are reused after deletion; only new slabs are allocated
+        vector<PooledObject*> objs;
+        objs.reserve( 10 );
+        for( int i = 0; i < 10; ++i ) objs.push_back( new PooledObject );
+        for( PooledObject* p : objs ) delete p;
+        objs.clear();
+        
+        AllocationCounter::count = 0;
+        AllocationCounter::enabled = true;
+        for( int n = 0; n < 100; ++n ){
+            for( int i = 0; i < 10; ++i ) objs.push_back( new PooledObject );
+            for( PooledObject* p : objs ) delete p;
+            objs.clear();
+        }
+        AllocationCounter::enabled = false;
+        TS_ASSERT_EQUALS( AllocationCounter::count, 0u );
+        
+        // derived classes of other sizes are not pooled (deleted via base)
+        AllocationCounter::count = 0;
+        AllocationCounter::enabled = true;
+        PooledObject* larger = new LargerObject;
+        AllocationCounter::enabled = false;
+        TS_ASSERT_EQUALS( AllocationCounter::count, 1u );
+        delete larger;
+    }
+    
+    void testObjectPoolThreads () {
+        // objects created on one thread and deleted on another (as infections
+        // of humans removed by the main thread) are reused: the number of
+        // slabs depends on the peak number of live objects, not on the
+        // number deleted over time
+        typedef util::ObjectPool<PooledObject> Pool;
+        const size_t n = 1000;
+        vector<PooledObject*> objs( n );
+        size_t slabs = 0;
+        for( int round = 0; round < 50; ++round ){
+            std::thread( [&objs](){
+                for( PooledObject*& p : objs ) p = new PooledObject;
+            } ).join();
+            for( PooledObject* p : objs ) delete p;
+            if( round == 9 ) slabs = Pool::slabCount();
+        }
+        TS_ASSERT_EQUALS( Pool::slabCount(), slabs );
+        // live objects plus at most 2 × SLAB_SIZE cached per thread
+        TS_ASSERT_LESS_THAN_EQUALS( Pool::slabCount(), (n + 4 * Pool::SLAB_SIZE) / Pool::SLAB_SIZE + 1 );
+    }
+
+private:
+    WHFalciparum* wh;
+    int oldYLagLen;
+};
+
+#endif
@@ -0,0 +1,80 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2025 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2025 University of Basel
+ * Copyright (C) 2025 The Kids Research Institute Australia
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef Hmod_AnophelesModelFitterSuite
+#define Hmod_AnophelesModelFitterSuite
+
+#include <cxxtest/TestSuite.h>
+#include "UnittestUtil.h"
+#include "Transmission/Anopheles/AnophelesModelFitter.h"
+
+using namespace OM::Transmission::Anopheles;
+
+class AnophelesModelFitterSuite : public CxxTest::TestSuite
+{
+public:
+    void setUp () {
+        UnittestUtil::initTime(1);
+    }
+    
+    void testFindAngle () {
+        // findAngleIndex must pick exactly the angle the brute-force search picks,
+        // for a range of seasonal patterns and simulated (noisy, shifted)
+        // series.
+        for( int c = 0; c < 40; ++c ){
+            vector<double> FC( 5 );
+            for( size_t i = 0; i < FC.size(); ++i )
+                FC[i] = (1 + c % 4) * 0.4 * sin( 2.1 * c + 1.7 * i );
+            vector<double> simulated( sim::oneYear() );
+            vectors::expIDFT( simulated, FC, 0.37 * c );
+            for( size_t t = 0; t < simulated.size(); ++t )
+                simulated[t] *= (1 + c % 3) * exp( 0.2 * sin( 12.9898 * t + 78.233 * c ) );
+            
+            const double rotate = 0.1 * c - 2.0;
+            TS_ASSERT_EQUALS( findAngleIndex( rotate, FC, simulated ),
+                              findAngleIndexBruteForce( rotate, FC, simulated ) );
+        }
+    }
+    
+    void testFindAngleSteps () {
+        // the angles fitting has always tried: accumulated from -π, which
+        // gives one extra angle just below π
+        const vector<double>& angles = findAngleSteps();
+        TS_ASSERT_EQUALS( angles.size(), FIND_ANGLE_STEPS + 1 );
+        double angle = -M_PI;
+        for( size_t k = 0; k < angles.size(); ++k, angle += 2.0 * M_PI / FIND_ANGLE_STEPS )
+            TS_ASSERT_EQUALS( angles[k], angle );
+        TS_ASSERT_LESS_THAN( angles.back(), M_PI );
+    }
+    
+    void testFindAngleFlat () {
+        // With no seasonality all angles are equally good: both take the first
+        vector<double> FC( 5, 0.0 );
+        FC[0] = 2.0;
+        vector<double> simulated( sim::oneYear(), 3.0 );
+        TS_ASSERT_EQUALS( findAngleIndex( 0.5, FC, simulated ), 0u );
+        TS_ASSERT_EQUALS( findAngleIndexBruteForce( 0.5, FC, simulated ), 0u );
+        TS_ASSERT_EQUALS( findAngle( 0.5, FC, simulated ), -M_PI );
+    }
+};
+
+#endif
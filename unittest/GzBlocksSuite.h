@@ -0,0 +1,106 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2025 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2025 University of Basel
+ * Copyright (C) 2025 The Kids Research Institute Australia
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef Hmod_GzBlocksSuite
+#define Hmod_GzBlocksSuite
+
+#include <cxxtest/TestSuite.h>
+#include "ExtraAsserts.h"
+
+#include "util/gzblocks.h"
+#include "util/errors.h"
+#include <gzstream/gzstream.h>
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+
+using namespace OM::util;
+
+class GzBlocksSuite : public CxxTest::TestSuite
+{
+public:
+    void tearDown () {
+        std::remove( fileName );
+    }
+    
+    void testRoundTrip () {
+        // empty, part of one block, and several blocks with a partial last one
+        for( size_t n : { size_t(0), size_t(1000), 3 * gzblocks::BLOCK_SIZE + 17 } ){
+            const string data = makeData( n );
+            gzblocks::writeFile( fileName, data );
+            ETS_ASSERT_EQUALS( gzblocks::readFile( fileName ).size(), n );
+            TS_ASSERT( gzblocks::readFile( fileName ) == data );
+        }
+    }
+    
+    void testReadPlainGzip () {
+        // as written by gzstream (checkpoints of earlier versions)
+        const string data = makeData( 2 * gzblocks::BLOCK_SIZE + 5 );
+        {
+            ogzstream out( fileName, ios::out | ios::binary );
+            out.write( data.data(), data.size() );
+        }
+        TS_ASSERT( gzblocks::readFile( fileName ) == data );
+    }
+    
+    void testReadGzstream () {
+        // and the other way round: gzip tools read the multi-member file
+        const string data = makeData( gzblocks::BLOCK_SIZE + 3 );
+        gzblocks::writeFile( fileName, data );
+        igzstream in( fileName, ios::in | ios::binary );
+        string result( (istreambuf_iterator<char>( in )), istreambuf_iterator<char>() );
+        TS_ASSERT( result == data );
+    }
+    
+    void testErrors () {
+        TS_ASSERT_THROWS( gzblocks::readFile( "no-such-file.gz" ), const checkpoint_error& );
+        const string data = makeData( 2 * gzblocks::BLOCK_SIZE );
+        gzblocks::writeFile( fileName, data );
+        {   // truncate
+            string compressed;
+            {
+                ifstream in( fileName, ios::in | ios::binary );
+                compressed.assign( istreambuf_iterator<char>( in ), istreambuf_iterator<char>() );
+            }
+            ofstream out( fileName, ios::out | ios::binary );
+            out.write( compressed.data(), compressed.size() - 10 );
+        }
+        TS_ASSERT_THROWS( gzblocks::readFile( fileName ), const checkpoint_error& );
+    }
+    
+private:
+    // compressible but not trivial
+    static string makeData( size_t n ){
+        string data( n, '\0' );
+        uint32_t x = 12345;
+        for( size_t i = 0; i < n; ++i ){
+            x = x * 1103515245 + 12345;
+            data[i] = char( (x >> 16) % 13 );
+        }
+        return data;
+    }
+    
+    const char* fileName = "GzBlocksSuite.gz";
+};
+
+#endif
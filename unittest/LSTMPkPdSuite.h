@@ -65,6 +65,25 @@ public:
 	TS_ASSERT_EQUALS (proxy->getDrugFactor (m_rng, inf, massAt21), 1.0);
     }
     
+    void testEmpty () {
+	// CommonWithinHost skips its daily update for hosts with no infections
+	// when this is empty; that is only equivalent if medicate() and
+	// decayDrugs() then have no effect and use no random numbers
+	TS_ASSERT( proxy->isEmpty() );
+	LocalRng rng(0, 721347520444481703);
+	for( int i = 0; i < 10; ++i ){
+	    proxy->medicate (m_rng);
+	    proxy->decayDrugs (massAt21);
+	}
+	TS_ASSERT( proxy->isEmpty() );
+	TS_ASSERT_EQUALS( m_rng.uniform_01(), rng.uniform_01() );
+
+	UnittestUtil::medicate( m_rng, *proxy, MQ_index, 3000, 0 );
+	TS_ASSERT( !proxy->isEmpty() );
+	proxy->decayDrugs (massAt21);
+	TS_ASSERT( !proxy->isEmpty() );
+    }
+
     void testOral () {
 	UnittestUtil::medicate( m_rng, *proxy, MQ_index, 3000, 0 );
 	TS_ASSERT_APPROX (proxy->getDrugFactor (m_rng, inf, massAt21), 0.03174563638523168);
@@ -27,11 +27,15 @@
 
 #include <cxxtest/TestSuite.h>
 #include "PkPd/LSTMModel.h"
+#include "PkPd/Drug/Quadrature.h"
 #include "Host/WithinHost/Infection/DummyInfection.h"
 #include "UnittestUtil.h"
 #include "ExtraAsserts.h"
+#include <gsl/gsl_errno.h>
+#include <gsl/gsl_integration.h>
 #include <limits>
 #include <cstdio>
+#include <thread>
 
 using std::pair;
 using std::multimap;
@@ -336,6 +340,180 @@ public:
         runDrugSimulations("PPQ3", drug_conc, drug_factors);
     }
     
+    /** Daily drug factors over 6 days for a triple dose, using a separate
+     * model, infection and RNG (so that this can be called from any thread). */
+    static vector<double> drugFactors( const string& drugName, double dose ){
+        LocalRng rng(0, 721347520444481703);
+        LSTMModel pkpd;
+        unique_ptr<CommonInfection> infection( createDummyInfection(rng, 0, InfectionOrigin::Indigenous) );
+        size_t drugIndex = LSTMDrugType::findDrug( drugName );
+        const double body_mass = 50;
+        vector<double> factors;
+        for( size_t i = 0; i < 6; i++ ){
+            factors.push_back( pkpd.getDrugFactor(rng, infection.get(), body_mass) );
+            pkpd.decayDrugs(body_mass);
+            if( i < 3 ) UnittestUtil::medicate( rng, pkpd, drugIndex, dose, 0 );
+        }
+        return factors;
+    }
+    
+    static double funcPeak( double t, void* ){
+        return 1.0 / (1e-4 + (t - 0.3) * (t - 0.3));
+    }
+    /// Uses a QAG workspace heavily (the peak needs many subdivisions)
+    static double integratePeak(){
+        double result, abserr;
+        integrateQag( &funcPeak, nullptr, 0.0, 1.0, 0.0, 1e-8, result, abserr );
+        return result;
+    }
+    
+    /* PK/PD code must be reentrant: drug factors calculated concurrently in
+     * several threads must equal those calculated serially. Covers one-,
+     * three-compartment and conversion models. */
+    void testThreads (){
+        const vector<pair<string, double>> drugs = {
+            { "MQ", 8.3 * bodymass }, { "PPQ3", 18 * bodymass }, { "AR", 1.7 * bodymass }
+        };
+        vector<vector<double>> expected;
+        for( auto& drug : drugs ) expected.push_back( drugFactors( drug.first, drug.second ) );
+        const double expectedPeak = integratePeak();
+        
+        const size_t nThreads = 4, nRepeats = 20;
+        vector<int> mismatches( nThreads, 0 );
+        vector<thread> threads;
+        for( size_t t = 0; t < nThreads; ++t ){
+            threads.emplace_back( [&, t](){
+                for( size_t r = 0; r < nRepeats; ++r ){
+                    for( size_t d = 0; d < drugs.size(); ++d ){
+                        if( drugFactors( drugs[d].first, drugs[d].second ) != expected[d] ) mismatches[t] += 1;
+                    }
+                    if( integratePeak() != expectedPeak ) mismatches[t] += 1;
+                }
+            } );
+        }
+        for( thread& t : threads ) t.join();
+        
+        for( size_t t = 0; t < nThreads; ++t ) TS_ASSERT_EQUALS( mismatches[t], 0 );
+        for( auto& factors : expected ) TS_ASSERT_LESS_THAN( factors[1], 0.1 );     // drugs work
+        TS_ASSERT_APPROX( expectedPeak, 100.0 * (atan(70.0) + atan(30.0)) );
+    }
+    
+    /// Killing function of the three-compartment model (as fC in LSTMDrugThreeComp.cpp)
+    struct ThreeCompKilling {
+        double cA, cB, cC, cABC, na, nb, ng, nka, n, V, Kn;
+        double operator()( double t ) const{
+            const double conc = cA * exp(na * t) + cB * exp(nb * t)
+                + cC * exp(ng * t) - cABC * exp(nka * t);
+            const double cn = pow(conc, n);
+            return V * cn / (cn + Kn);
+        }
+    };
+    /// Killing function of the conversion model (as convFactor in LSTMDrugConversion.cpp)
+    struct ConversionKilling {
+        double qtyG, qtyP, qtyM, nka, nkM, nl, f, g, h, i, j;
+        double invVdP, invVdM, nP, nM, VP, VM, KnP, KnM;
+        
+        /// Parameters as set by LSTMDrugConversion::setConversionParameters
+        ConversionKilling( double qtyG, double qtyP, double qtyM, double x,
+                double y, double z, double k, double mwr, double VdP, double VdM,
+                double body_mass ) :
+            qtyG(qtyG), qtyP(qtyP), qtyM(qtyM), nka(-x), nkM(-k), nl(-(y + z))
+        {
+            f = nka / (nl - nka);
+            const double rz = mwr * -z;
+            g = rz * nka / ((nka - nl) * (nka - nkM));
+            h = rz * nka / ((nka - nl) * (nkM - nl));
+            i = rz / (nl - nkM);
+            j = rz * nka / ((nkM - nl) * (nkM - nka));
+            invVdP = 1.0 / (VdP * body_mass); invVdM = 1.0 / (VdM * body_mass);
+        }
+        double operator()( double t ) const{
+            const double expAbsorb = exp(nka * t), expPLoss = exp(nl * t);
+            const double cP = (f * qtyG * expAbsorb + (qtyP - f * qtyG) * expPLoss) * invVdP;
+            const double cM = (g * qtyG * expAbsorb + (h * qtyG - i * qtyP) * expPLoss
+                + (j * qtyG + i * qtyP + qtyM) * exp(nkM * t)) * invVdM;
+            const double cnP = pow(cP, nP), cnM = pow(cM, nM);
+            return max(VP * cnP / (cnP + KnP), VM * cnM / (cnM + KnM));
+        }
+    };
+    template<class F>
+    static double callKilling( double t, void* pp ){
+        return (*static_cast<const F*>( pp ))( t );
+    }
+    
+    /** Integrate f over [0, duration] with integrateGK15 and with the first
+     * step of gsl_integration_qag (with limit 1, GSL returns the result and
+     * error estimate of its first step, with an error status if it would
+     * subdivide). Both must agree exactly.
+     * 
+     * @returns true if the step is accepted (no fallback to QAG) */
+    template<class F>
+    static bool checkGK15( const F& f, double duration, double epsabs, double epsrel ){
+        double result, abserr;
+        const bool accepted = integrateGK15( f, 0.0, duration, epsabs, epsrel, result, abserr );
+        
+        gsl_function gslF;
+        gslF.function = &callKilling<F>;
+        gslF.params = const_cast<F*>( &f );
+        gsl_integration_workspace *w = gsl_integration_workspace_alloc( 1 );
+        gsl_error_handler_t *handler = gsl_set_error_handler_off();
+        double qagResult, qagAbserr;
+        const int status = gsl_integration_qag( &gslF, 0.0, duration, epsabs, epsrel,
+                1, GSL_INTEG_GAUSS15, w, &qagResult, &qagAbserr );
+        gsl_set_error_handler( handler );
+        gsl_integration_workspace_free( w );
+        
+        TS_ASSERT_EQUALS( accepted, status == GSL_SUCCESS );
+        TS_ASSERT_EQUALS( result, qagResult );
+        TS_ASSERT_EQUALS( abserr, qagAbserr );
+        return accepted;
+    }
+    
+    /* The three-compartment and conversion models use integrateGK15 in place
+     * of QAG's first step; results must be identical to QAG's (including the
+     * decision to fall back to QAG). Parameters are those of PPQ3 and AR
+     * (with DHA) above, over part of and whole days after a dose. */
+    void testIntegrateGK15 (){
+        int accepted = 0, fallback = 0;
+        
+        // PPQ3 at 50 kg (alpha, beta, gamma as in LSTMDrugThreeComp::updateCached)
+        ThreeCompKilling ppq = { 0.0, 0.0, 0.0, 0.0, -0.018670, -3.8859, -0.41275, -3.4825,
+            6.0, 3.45, pow(0.020831339, 6.0) };
+        const double ppqConc[][3] = {
+            { 0.1, 0.03, 0.005 }, { 0.05, 0.04, 0.02 }, { 0.002, 0.01, 0.01 }, { 1.0, 0.2, 0.02 }
+        };
+        for( const double *c : ppqConc ){
+            for( double absorbed : { 0.0, 1.0 } ){
+                ppq.cA = c[0]; ppq.cB = c[1]; ppq.cC = c[2];
+                // absorbed: no drug left in the gut; otherwise a fresh dose
+                ppq.cABC = absorbed > 0.0 ? 0.0 : c[0] + c[1] + c[2];
+                for( double duration : { 1.0, 0.5, 0.25, 0.1 } ){
+                    if( checkGK15( ppq, duration, 1e-4, 1e-4 ) ) ++accepted; else ++fallback;
+                }
+            }
+        }
+        
+        // AR, converted to DHA, at 50 kg
+        for( double qtyG : { 85.0, 10.0, 0.0 } ){
+            for( double qtyP : { 0.0, 20.0 } ){
+                for( double qtyM : { 0.0, 5.0 } ){
+                    if( qtyG == 0.0 && qtyP == 0.0 && qtyM == 0.0 ) continue;
+                    ConversionKilling ar( qtyG, qtyP, qtyM, 23.98, 0.0, 11.98, 44.15,
+                            0.9547587, 46.6, 15.0, 50.0 );
+                    ar.nP = 4.0; ar.VP = 27.6; ar.KnP = pow(0.0023, 4.0);
+                    ar.nM = 4.0; ar.VM = 27.6; ar.KnM = pow(0.009, 4.0);
+                    for( double duration : { 1.0, 0.5, 0.25, 0.1 } ){
+                        if( checkGK15( ar, duration, 1e-5, 1e-2 ) ) ++accepted; else ++fallback;
+                    }
+                }
+            }
+        }
+        
+        // both outcomes are covered
+        TS_ASSERT_LESS_THAN( 0, accepted );
+        TS_ASSERT_LESS_THAN( 0, fallback );
+    }
+    
 private:
     LocalRng m_rng;
     LSTMModel *proxy;
@@ -27,6 +27,7 @@
 #include "ExtraAsserts.h"
 
 #include "util/vectors.h"
+#include <memory>
 
 using namespace OM::util;
 using OM::sim;
@@ -49,6 +50,67 @@ public:
         for( size_t i=0; i<result.size(); ++i )
             TS_ASSERT_APPROX( input[i], result[i] );
     }
+    
+    void testCompact() {
+        // Remove odd numbers and anything after 5 elements are kept, as
+        // Population::update does with deaths and out-migration
+        vector<unique_ptr<int>> list;
+        for( int i = 0; i < 20; ++i )
+            list.push_back( unique_ptr<int>(new int(i)) );
+        int kept = 0, calls = 0;
+        vectors::compact( list, [&]( const unique_ptr<int>& x ){
+            TS_ASSERT_EQUALS( *x, calls );      // called once per element, in order
+            ++calls;
+            if( *x % 2 == 1 || kept >= 5 ) return true;
+            ++kept;
+            return false;
+        } );
+        TS_ASSERT_EQUALS( calls, 20 );
+        ETS_ASSERT_EQUALS( list.size(), 5u );
+        for( size_t i = 0; i < list.size(); ++i )
+            TS_ASSERT_EQUALS( *list[i], int(2 * i) );
+    }
+    
+    void testFft() {
+        // Compare with the DFT by definition; lengths cover powers of two,
+        // primes and mixed factors (365 is the length used by findAngle)
+        for( size_t n : { 1, 2, 7, 12, 64, 365 } ){
+            vector<complex<double>> x( n );
+            for( size_t t = 0; t < n; ++t )
+                x[t] = complex<double>( sin( 1.3 * t ) + 0.1 * t, cos( 0.7 * t * t ) );
+            vector<complex<double>> X( x );
+            vectors::fft( X, -1 );
+            for( size_t k = 0; k < n; ++k ){
+                complex<double> expected = 0.0;
+                for( size_t t = 0; t < n; ++t )
+                    expected += std::polar( 1.0, -2.0 * M_PI * k * t / n ) * x[t];
+                TS_ASSERT_DELTA( X[k].real(), expected.real(), 1e-9 );
+                TS_ASSERT_DELTA( X[k].imag(), expected.imag(), 1e-9 );
+            }
+            // the inverse (unscaled) gets back n·x
+            vectors::fft( X, +1 );
+            for( size_t t = 0; t < n; ++t ){
+                TS_ASSERT_DELTA( X[t].real() / n, x[t].real(), 1e-9 );
+                TS_ASSERT_DELTA( X[t].imag() / n, x[t].imag(), 1e-9 );
+            }
+        }
+    }
+    
+    void testCircularCrossCorrelation() {
+        const size_t n = 15;
+        vector<double> a( n ), b( n ), corr;
+        for( size_t t = 0; t < n; ++t ){
+            a[t] = 1.0 + sin( 0.9 * t );
+            b[t] = double( (t * 7) % 5 );
+        }
+        vectors::circularCrossCorrelation( a, b, corr );
+        ETS_ASSERT_EQUALS( corr.size(), n );
+        for( size_t k = 0; k < n; ++k ){
+            double expected = 0.0;
+            for( size_t t = 0; t < n; ++t ) expected += a[(t + n - k) % n] * b[t];
+            TS_ASSERT_DELTA( corr[k], expected, 1e-9 );
+        }
+    }
 };
 
 #endif
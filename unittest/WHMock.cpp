@@ -36,7 +36,7 @@ WHMock::WHMock() :
 {}
 WHMock::~WHMock() {}
 
-double WHMock::probTransmissionToMosquito(vector<double> &, vector<double> &) const{
+double WHMock::probTransmissionToMosquito(vector<GenotypeTransmission> &) const{
     throw util::unimplemented_exception( "not needed in unit test" );
 }
 
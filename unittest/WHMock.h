@@ -47,7 +47,7 @@ public:
     WHMock();
     virtual ~WHMock();
     
-    virtual double probTransmissionToMosquito(vector<double> &probTransGenotype_i, vector<double> &probTransGenotype_l) const;
+    virtual double probTransmissionToMosquito(vector<GenotypeTransmission> &probTransGenotype) const;
     virtual bool summarize(Host::Human& human)const;
     virtual void importInfection(LocalRng& rng);
     virtual void treatment( Host::Human& human, TreatmentId treatId );
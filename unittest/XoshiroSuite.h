@@ -24,7 +24,9 @@
 #define Hmod_XoshiroSuite
 
 #include <cxxtest/TestSuite.h>
+#include "util/random.h"
 #include "util/xoshiro.h"
+#include <vector>
 
 class XoshiroSuite : public CxxTest::TestSuite
 {
@@ -53,6 +55,25 @@ public:
             TS_ASSERT_EQUALS(x, vector[n]);
         }
     }
+    
+    void testLocalRngSize () {
+        // There is one LocalRng per human: it should hold only the generator
+        // state (the GSL adaptor is shared by all RNGs of a type).
+        TS_ASSERT_EQUALS(sizeof(OM::util::LocalRng), sizeof(Xoshiro256P));
+        TS_ASSERT_EQUALS(sizeof(Xoshiro256P), 4 * sizeof(uint64_t));
+    }
+    
+    void testLocalRngMove () {
+        // A moved RNG continues the same sequence, including via GSL
+        OM::util::LocalRng a(17, 5), b(17, 5);
+        std::vector<OM::util::LocalRng> moved;
+        moved.push_back(std::move(a));
+        for (int n = 0; n < 5; n++) {
+            TS_ASSERT_EQUALS(moved[0].uniform_01(), b.uniform_01());
+            TS_ASSERT_EQUALS(moved[0].gauss(1.0, 2.0), b.gauss(1.0, 2.0));
+            TS_ASSERT_EQUALS(moved[0].poisson(3.0), b.poisson(3.0));
+        }
+    }
 };
 
 #endif
@@ -19,6 +19,10 @@
 # along with this program; if not, write to the Free Software
 # Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
 
+import array
+import gzip
+import struct
+import sys
 import unittest
 
 class Keys:
@@ -274,11 +278,15 @@ def robustFloat(s):
             raise
 
 def readEntries (fname):
-    """Return a dict of entries read from file. Keys have type Multi3Keys,
-    where a corresponds to measure, b to survey and c to group.
+    """Return a dict of entries read from file (text or binary). Keys have
+    type Multi3Keys, where a corresponds to measure, b to survey and c to group.
     
     Note: ValDict is probably more efficient due to use of arrays over dicts."""
     values=dict()
+    if isBinary(fname):
+        for s,g,m,v in BinaryOutput(fname).entries():
+            values[Multi3Keys(m,s,g)]=v
+        return values
     fileObj = open(fname, 'r')
     for line in fileObj:
         items=line.split()
@@ -291,5 +299,161 @@ def readEntries (fname):
         values[key]=robustFloat(items[3])
     return values
 
+
+# ———  binary output (openMalaria --binary-output)  ———
+
+BINARY_MAGIC=b"OMOUTBIN"
+
+def openMaybeGz(fname):
+    if fname.endswith(".gz"):
+        return gzip.open(fname, 'rb')
+    return open(fname, 'rb')
+
+def isBinary(fname):
+    """True if fname is an output file in the binary format."""
+    with openMaybeGz(fname) as f:
+        return f.read(len(BINARY_MAGIC)) == BINARY_MAGIC
+
+class BinaryMeasure(object):
+    """Description of one output measure in the binary format."""
+    def __init__(self,outId,isDouble,flags,offset,dims):
+        self.outId=outId
+        self.isDouble=isDouble
+        self.byAge=bool(flags & 1)
+        self.bySpecies=bool(flags & 2)
+        self.byDrug=bool(flags & 4)
+        self.offset=offset
+        self.nAges,self.nCohorts,self.nSpecies,self.nGenotypes,self.nDrugs=dims
+    def index(self,age,cohort,species,genotype,drug):
+        """Index of a value within the survey's values of this type."""
+        return self.offset + (((age * self.nCohorts + cohort) * self.nSpecies
+            + species) * self.nGenotypes + genotype) * self.nDrugs + drug
+
+class BinaryOutput(object):
+    """Output written with --binary-output (format described in
+    model/mon/mon.cpp).
+    
+    ints[s] and doubles[s] are arrays of the values of survey s (counting from
+    0) as stored by OpenMalaria; measures lists a BinaryMeasure for each
+    output measure, in order of output id."""
+    def __init__(self,fname):
+        with openMaybeGz(fname) as f:
+            data=f.read()
+        if data[:8] != BINARY_MAGIC:
+            raise Exception(fname+" is not a binary OpenMalaria output file")
+        # values are in the byte order of the writer; version is 1
+        self.order='<' if struct.unpack_from('<I',data,8)[0] == 1 else '>'
+        if struct.unpack_from(self.order+'I',data,8)[0] != 1:
+            raise Exception(fname+": unsupported version of binary output")
+        self.pos=12
+        self.nSurveys,nCohorts=self.unpack(data,'II')
+        self.cohortIds=self.unpack(data,'%dI' % nCohorts)
+        sizeI,sizeF,nMeasures=self.unpack(data,'III')
+        self.measures=list()
+        for i in range(nMeasures):
+            v=self.unpack(data,'iIII5I')
+            self.measures.append(BinaryMeasure(v[0],v[1]==1,v[2],v[3],v[4:]))
+        self.ints=list()
+        self.doubles=list()
+        for s in range(self.nSurveys):
+            self.ints.append(self.unpackArray(data,'i',sizeI))
+            self.doubles.append(self.unpackArray(data,'d',sizeF))
+        self.imrId,self.imr=self.unpack(data,'id')
+    
+    def unpack(self,data,fmt):
+        fmt=self.order+fmt
+        v=struct.unpack_from(fmt,data,self.pos)
+        self.pos+=struct.calcsize(fmt)
+        return v
+    def unpackArray(self,data,typecode,n):
+        a=array.array(typecode)
+        assert a.itemsize == (8 if typecode == 'd' else 4)
+        end=self.pos+n*a.itemsize
+        if end > len(data):
+            raise Exception("binary output file is truncated")
+        a.frombytes(data[self.pos:end])
+        if (self.order == '<') != (sys.byteorder == 'little'):
+            a.byteswap()
+        self.pos=end
+        return a
+    
+    def entries(self):
+        """Yield (survey, group, measure, value) tuples, exactly as on the
+        lines of output.txt (in the same order). Surveys count from 1."""
+        for s in range(self.nSurveys):
+            for m in self.measures:
+                values=self.doubles[s] if m.isDouble else self.ints[s]
+                for g,i in self.groups(m):
+                    yield (s+1,g,m.outId,values[i])
+        if self.imrId >= 0:
+            yield (1,1,self.imrId,self.imr)
+    def groups(self,m):
+        """Yield (group, index) for each value reported by measure m, where
+        group is the second column of output.txt."""
+        nAgeCats=1 if m.nAges == 1 else m.nAges - 1
+        ageAdd=1 if m.byAge else 0
+        if m.bySpecies:
+            for sp in range(m.nSpecies):
+                for gt in range(m.nGenotypes):
+                    yield (sp + 1 + 1000000 * gt, m.index(0,0,sp,gt,0))
+        elif m.byDrug:
+            for c in range(m.nCohorts):
+                for a in range(nAgeCats):
+                    for d in range(m.nDrugs):
+                        yield (a + ageAdd + 1000 * self.cohortIds[c] + 1000000 * (d + 1),
+                            m.index(a,c,0,0,d))
+        else:
+            for c in range(m.nCohorts):
+                for a in range(nAgeCats):
+                    for gt in range(m.nGenotypes):
+                        yield (a + ageAdd + 1000 * self.cohortIds[c] + 1000000 * gt,
+                            m.index(a,c,0,gt,0))
+
+def formatValue(v):
+    """Format a value as OpenMalaria does in output.txt."""
+    if isinstance(v,float):
+        return "%g" % v
+    return str(v)
+
+def binaryToText(binName,textName):
+    """Convert binary output binName to the text format, writing textName."""
+    with open(textName,'w') as f:
+        for s,g,m,v in BinaryOutput(binName).entries():
+            f.write("%d\t%d\t%d\t%s\n" % (s,g,m,formatValue(v)))
+
+class TestBinaryOutput (unittest.TestCase):
+    def write(self,fname,order):
+        def p(fmt,*v):
+            return struct.pack(order+fmt,*v)
+        # two surveys; one cohort set (id 0); 3 age groups (2 reported)
+        data=BINARY_MAGIC+p('III',1,2,1)+p('I',0)+p('II',4,1)+p('I',3)
+        data+=p('iIII5I',0,0,1,0,3,1,1,1,1)     # nHost by age (3 slots)
+        data+=p('iIII5I',5,0,0,3,1,1,1,1,1)     # an int measure with one value
+        # measure 32 (Vector_Nv) by species uses the float64 block:
+        data+=p('iIII5I',32,1,2,0,1,1,1,1,1)
+        for s in range(2):
+            data+=p('4i',10+s,20+s,99,7*s)+p('d',0.5+s)
+        data+=p('id',-1,0.0)
+        with open(fname,'wb') as f:
+            f.write(data)
+    def testRead(self):
+        import os, tempfile
+        for order in '<>':
+            fd,fname=tempfile.mkstemp()
+            os.close(fd)
+            try:
+                self.write(fname,order)
+                self.assertTrue(isBinary(fname))
+                entries=list(BinaryOutput(fname).entries())
+            finally:
+                os.remove(fname)
+            self.assertEqual(entries, [(1,1,0,10),(1,2,0,20),(1,0,5,0),(1,1,32,0.5),
+                (2,1,0,11),(2,2,0,21),(2,0,5,7),(2,1,32,1.5)])
+            self.assertEqual([formatValue(e[3]) for e in entries[:4]], ["10","20","0","0.5"])
+
 if __name__ == '__main__':
-    unittest.main()
+    if len(sys.argv) == 3 and sys.argv[1] != '-v':
+        # usage: readOutput.py output.bin output.txt
+        binaryToText(sys.argv[1],sys.argv[2])
+    else:
+        unittest.main()